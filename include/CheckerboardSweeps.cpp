@@ -0,0 +1,165 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file CheckerboardSweeps.cpp
+ * \brief Parallel displacement sweeps over a checkerboard of domains -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef CHECKERBOARDSWEEPS_HPP
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include <cmath>
+
+#include <SeedMixing.hpp>
+
+namespace mcchd
+{
+  /// seed gives the streams of the sweep and of the threads, num_threads 0 for one per core
+  template <class Configuration, class RandomNumberGenerator>
+  inline CheckerboardSweeps<Configuration, RandomNumberGenerator>::CheckerboardSweeps(Configuration* new_configuration, const uint32_t& seed, const uint32_t& new_num_threads)
+    : configuration(new_configuration), extents(new_configuration->get_extents()), num_threads(new_num_threads)
+  {
+    if (num_threads == 0)
+      num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0)
+      num_threads = 1;
+
+    // an odd number of blocks would give two neighbours of the same colour across the periodic boundary
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	num_blocks[axis] = static_cast<index_type> (floor(extents[axis] / min_block_width));
+	num_blocks[axis] = (num_blocks[axis] >= 2) ? num_blocks[axis] - num_blocks[axis] % 2 : 1;
+	block_width[axis] = extents[axis] / num_blocks[axis];
+      }
+
+    block_discs.resize(num_blocks[0] * num_blocks[1] * num_blocks[2]);
+    colour_blocks.resize(num_colours);
+    for (index_type i = 0; i < num_blocks[0]; i++)
+      for (index_type j = 0; j < num_blocks[1]; j++)
+	for (index_type k = 0; k < num_blocks[2]; k++)
+	  colour_blocks[(i % 2) * 4 + (j % 2) * 2 + (k % 2)].push_back((i * num_blocks[1] + j) * num_blocks[2] + k);
+
+    sweep_rng.set_seed(mix_seed(seed, num_threads));
+    thread_rngs.resize(num_threads);
+    for (uint32_t thread_idx = 0; thread_idx < num_threads; thread_idx++)
+      thread_rngs[thread_idx].set_seed(mix_seed(seed, thread_idx));
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline CheckerboardSweeps<Configuration, RandomNumberGenerator>::~CheckerboardSweeps()
+  {
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline const multi_index_type& CheckerboardSweeps<Configuration, RandomNumberGenerator>::get_num_blocks() const
+  {
+    return num_blocks;
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline const uint32_t& CheckerboardSweeps<Configuration, RandomNumberGenerator>::get_num_threads() const
+  {
+    return num_threads;
+  }
+
+  /// index along axis of the block the point is in, with the offset of this sweep
+  template <class Configuration, class RandomNumberGenerator>
+  inline index_type CheckerboardSweeps<Configuration, RandomNumberGenerator>::get_block_idx(const Point& point, const uint8_t& axis) const
+  {
+    double shifted_coor = point.get_coor(axis) - block_offset[axis];
+    if (shifted_coor < 0.)
+      shifted_coor += extents[axis];
+    const index_type block_idx = static_cast<index_type> (floor(shifted_coor / block_width[axis]));
+    return std::min(block_idx, num_blocks[axis] - 1);
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline std::size_t CheckerboardSweeps<Configuration, RandomNumberGenerator>::get_block(const Point& point) const
+  {
+    return (get_block_idx(point, 0) * num_blocks[1] + get_block_idx(point, 1)) * num_blocks[2] + get_block_idx(point, 2);
+  }
+
+  /// body of a thread: the blocks of the colour with index thread_idx, thread_idx + num_threads, ...
+  template <class Configuration, class RandomNumberGenerator>
+  inline void CheckerboardSweeps<Configuration, RandomNumberGenerator>::sweep_blocks(const uint32_t& colour, const uint32_t& thread_idx, uint64_t& accepted_moves)
+  {
+    RandomNumberGenerator* rng = &thread_rngs[thread_idx];
+    const std::vector<std::size_t>& blocks = colour_blocks[colour];
+    for (std::size_t block_pos = thread_idx; block_pos < blocks.size(); block_pos += num_threads)
+      {
+	const std::size_t block = blocks[block_pos];
+	const DiscVec& discs = block_discs[block];
+	for (std::size_t attempt = 0; attempt < discs.size(); attempt++)
+	  {
+	    const disc_id_type disc_idx = discs[rng->random_uint32(0, discs.size() - 1)];
+	    const Point displacement(rng, max_move_size);
+	    Point displaced_center = configuration->get_disc_center(disc_idx) + displacement;
+	    displaced_center.rebase_periodic(extents);
+	    if (get_block(displaced_center) != block || configuration->is_overlapping_after_displacement(disc_idx, displacement))
+	      continue;
+	    configuration->move_disc(disc_idx, displacement);
+	    accepted_moves++;
+	  }
+      }
+  }
+
+  /// one displacement move per disc on average, returns the number of accepted moves
+  /// The free cell index of cavity bias is not safe for concurrent moves, it is switched off during the sweep and rebuilt afterwards.
+  template <class Configuration, class RandomNumberGenerator>
+  inline uint64_t CheckerboardSweeps<Configuration, RandomNumberGenerator>::sweep()
+  {
+    const bool cavity_bias = configuration->get_cavity_bias();
+    if (cavity_bias)
+      configuration->set_cavity_bias(false);
+
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      block_offset[axis] = (num_blocks[axis] > 1) ? sweep_rng.random_double() * block_width[axis] : 0.;
+
+    // discs only move within their block, so the lists hold for the whole sweep
+    for (std::size_t block = 0; block < block_discs.size(); block++)
+      block_discs[block].clear();
+    for (disc_id_type disc_idx = 0; disc_idx < configuration->get_number_of_discs(); disc_idx++)
+      block_discs[get_block(configuration->get_disc_center(disc_idx))].push_back(disc_idx);
+
+    uint32_t colour_order[num_colours];
+    for (uint32_t colour = 0; colour < num_colours; colour++)
+      colour_order[colour] = colour;
+    for (uint32_t colour = num_colours - 1; colour > 0; colour--)
+      std::swap(colour_order[colour], colour_order[sweep_rng.random_uint32(0, colour)]);
+
+    std::vector<uint64_t> accepted_moves(num_threads, 0);
+    for (uint32_t colour_pos = 0; colour_pos < num_colours; colour_pos++)
+      {
+	const uint32_t colour = colour_order[colour_pos];
+	const uint32_t busy_threads = std::min<std::size_t>(num_threads, colour_blocks[colour].size());
+	if (busy_threads == 1)
+	  {
+	    sweep_blocks(colour, 0, accepted_moves[0]);
+	    continue;
+	  }
+
+	std::vector<std::thread> sweep_threads;
+	for (uint32_t thread_idx = 0; thread_idx < busy_threads; thread_idx++)
+	  sweep_threads.push_back(std::thread(&CheckerboardSweeps<Configuration, RandomNumberGenerator>::sweep_blocks, this, colour, thread_idx, std::ref(accepted_moves[thread_idx])));
+	for (uint32_t thread_idx = 0; thread_idx < busy_threads; thread_idx++)
+	  sweep_threads[thread_idx].join();
+      }
+
+    uint64_t total_accepted_moves = 0;
+    for (uint32_t thread_idx = 0; thread_idx < num_threads; thread_idx++)
+      total_accepted_moves += accepted_moves[thread_idx];
+    configuration->add_simulation_time(total_accepted_moves);
+
+    if (cavity_bias)
+      configuration->set_cavity_bias(true);
+    return total_accepted_moves;
+  }
+
+}
+
+#endif
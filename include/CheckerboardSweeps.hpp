@@ -0,0 +1,90 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file CheckerboardSweeps.hpp
+ * \brief Parallel displacement sweeps over a checkerboard of domains -- header
+ *
+ * Every axis of the box is split into an even number of blocks, or left
+ * whole if it is too short for two. The blocks are coloured by the parity
+ * of their index along each axis, which gives up to 8 colours. Two blocks
+ * of the same colour are at least one block apart along some axis.
+ *
+ * A sweep passes through the colours in random order. The blocks of one
+ * colour are shared out to the threads, each thread with its own random
+ * number stream. Within its blocks a thread tries displacement moves of
+ * the discs centered there, as many as there are such discs. A move which
+ * would leave the block of the disc is rejected, which keeps detailed
+ * balance, as the reverse move would leave the block as well. The blocks
+ * are shifted by a random offset before every sweep, so no disc stays
+ * pinned to one block.
+ *
+ * A block is at least min_block_width wide: one diameter of reach of the
+ * neighbour stencil around a disc, one cell the disc may stick out of its
+ * block, and one cell each for the sub cell and the visited cell of the
+ * stencil. So two threads never touch the same cell or the same disc.
+ * The lookup table has to store every cell on its own, as LookupTable_Fast
+ * and LookupTable_Flat do.
+ *
+ * The number of discs does not change, insertions and removals are left
+ * to the single threaded simulation between sweeps.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef CHECKERBOARDSWEEPS_HPP
+#define CHECKERBOARDSWEEPS_HPP
+
+#include <vector>
+
+#include <cmath>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <Step.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd
+{
+  /// reach of the neighbour stencil plus three cells of the widest grid, cell diagonal one diameter
+  const double min_block_width = 2. * DEFAULT_DISC_RADIUS * (1. + 3. / sqrt(3.));
+  const uint32_t num_colours = 8;
+
+  template <class Configuration, class RandomNumberGenerator>
+  class CheckerboardSweeps
+  {
+  private:
+    Configuration* configuration;
+    coordinate_type extents;
+    uint32_t num_threads;
+    multi_index_type num_blocks;
+    coordinate_type block_width;
+    /// shift of the blocks of this sweep
+    coordinate_type block_offset;
+    /// offsets and colour order
+    RandomNumberGenerator sweep_rng;
+    /// one stream per thread
+    std::vector<RandomNumberGenerator> thread_rngs;
+    /// discs centered in each block, row major by block index
+    std::vector<DiscVec> block_discs;
+    /// blocks of each colour
+    std::vector<std::vector<std::size_t> > colour_blocks;
+
+    index_type get_block_idx(const Point&, const uint8_t&) const;
+    std::size_t get_block(const Point&) const;
+    void sweep_blocks(const uint32_t&, const uint32_t&, uint64_t&);
+
+    CheckerboardSweeps(const CheckerboardSweeps&);
+    CheckerboardSweeps& operator=(const CheckerboardSweeps&);
+  public:
+    CheckerboardSweeps(Configuration*, const uint32_t&, const uint32_t& = 0);
+    ~CheckerboardSweeps();
+    const multi_index_type& get_num_blocks() const;
+    const uint32_t& get_num_threads() const;
+    uint64_t sweep();
+  };
+
+}
+
+#include <CheckerboardSweeps.cpp>
+
+#endif
@@ -0,0 +1,98 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file Checkpoint.cpp
+ * \brief Binary checkpoint of a Wang Landau run -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef CHECKPOINT_HPP
+
+#include <fstream>
+
+#include <cstdio>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/string.hpp>
+
+namespace mcchd
+{
+  template <class ConfigurationType, class HistogramType, class IncidenceHistogramType>
+  inline Checkpoint<ConfigurationType, HistogramType, IncidenceHistogramType>::Checkpoint(ConfigurationType* new_configuration) : configuration(new_configuration), modification_factor(0.), resume_seed(0), sweep_count(0)
+  {
+  }
+
+  template <class ConfigurationType, class HistogramType, class IncidenceHistogramType>
+  inline Checkpoint<ConfigurationType, HistogramType, IncidenceHistogramType>::~Checkpoint()
+  {
+  }
+
+  /// flushes the file or directory name to the disk
+  /// Directories of some file systems cannot be synced, that is left to the file system.
+  inline void sync_to_disk(const std::string& name)
+  {
+    const int file_descriptor = open(name.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+      throw checkpoint_write_exception();
+    const bool synced = (fsync(file_descriptor) == 0 || errno == EINVAL);
+    close(file_descriptor);
+    if (!synced)
+      throw checkpoint_write_exception();
+  }
+
+  /// writes filename.tmp and renames it onto filename
+  /// The temporary file is on the disk before the rename, and the rename before returning, so a crash leaves either the old or the new checkpoint.
+  template <class ConfigurationType, class HistogramType, class IncidenceHistogramType>
+  inline void Checkpoint<ConfigurationType, HistogramType, IncidenceHistogramType>::save(const std::string& filename) const
+  {
+    const std::string temporary_filename = filename + ".tmp";
+    {
+      std::ofstream output_fstream(temporary_filename.c_str(), std::ios::binary);
+      if (! output_fstream)
+	throw checkpoint_write_exception();
+
+      boost::archive::binary_oarchive output_archive(output_fstream);
+      const std::string magic = checkpoint_magic;
+      output_archive << magic;
+      output_archive << checkpoint_version;
+      output_archive << (*this);
+
+      output_fstream.flush();
+      if (! output_fstream)
+	throw checkpoint_write_exception();
+    }
+
+    sync_to_disk(temporary_filename);
+    if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0)
+      throw checkpoint_write_exception();
+    const std::string::size_type separator_pos = filename.rfind('/');
+    sync_to_disk((separator_pos == std::string::npos) ? std::string(".") : filename.substr(0, separator_pos + 1));
+  }
+
+  template <class ConfigurationType, class HistogramType, class IncidenceHistogramType>
+  inline void Checkpoint<ConfigurationType, HistogramType, IncidenceHistogramType>::load(const std::string& filename)
+  {
+    std::ifstream input_fstream(filename.c_str(), std::ios::binary);
+    if (! input_fstream)
+      throw checkpoint_format_exception();
+
+    boost::archive::binary_iarchive input_archive(input_fstream);
+    std::string magic;
+    uint32_t version;
+    input_archive >> magic;
+    input_archive >> version;
+    if (magic != checkpoint_magic || version > checkpoint_version)
+      throw checkpoint_format_exception();
+
+    input_archive >> (*this);
+  }
+
+}
+
+#endif
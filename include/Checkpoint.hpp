@@ -0,0 +1,94 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file Checkpoint.hpp
+ * \brief Binary checkpoint of a Wang Landau run -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * A checkpoint holds the configuration (box, disc centers, simulation time),
+ * the entropy estimate, the incidence counter, the current modification
+ * factor and the number of completed sweeps. It is written to a temporary
+ * file which is synced to the disk and renamed onto the target, so an
+ * interrupted write or a crash never replaces a good checkpoint.
+ *
+ * The state of the random number generator is not accessible through the
+ * simulation interface. Instead, the run continues with resume_seed after
+ * writing the checkpoint, mix_seed of the seed and the sweep count, and a
+ * restart seeds with the same value, which makes the restarted run identical
+ * to the uninterrupted one. This needs checkpoints taken at the end of a
+ * sweep, which is where mcchd_wl writes them, also on SIGTERM.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+#include <exception>
+
+#include <boost/serialization/access.hpp>
+
+#include <SeedMixing.hpp>
+
+namespace mcchd
+{
+  /// first entry of every checkpoint file
+  const char* const checkpoint_magic = "mcchd checkpoint";
+  const uint32_t checkpoint_version = 1;
+
+  class checkpoint_format_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "Not an mcchd checkpoint, or one of a newer version.";
+    }
+  };
+
+  class checkpoint_write_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "Could not write the checkpoint file.";
+    }
+  };
+
+  /// ConfigurationType is a HardDiscs, the histograms have to be serializable by boost
+  template <class ConfigurationType, class HistogramType, class IncidenceHistogramType>
+  class Checkpoint
+  {
+  private:
+    /// saved from and loaded into in place, not owned
+    ConfigurationType* configuration;
+
+    friend class boost::serialization::access;
+    template<class Archive> void serialize(Archive & ar, const unsigned int)
+    {
+      ar & (*configuration);
+      ar & log_density_of_states;
+      ar & incidence_counter;
+      ar & modification_factor;
+      ar & resume_seed;
+      ar & sweep_count;
+    }
+
+  public:
+    HistogramType log_density_of_states;
+    IncidenceHistogramType incidence_counter;
+    double modification_factor;
+    uint32_t resume_seed;
+    uint64_t sweep_count;
+
+    Checkpoint(ConfigurationType*);
+    ~Checkpoint();
+    void save(const std::string&) const;
+    void load(const std::string&);
+  };
+
+}
+
+#include <Checkpoint.cpp>
+
+#endif
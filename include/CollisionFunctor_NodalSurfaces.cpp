@@ -16,6 +16,28 @@
 
 namespace mcchd
 {
+  /// sine and cosine of angle, for angles of a few periods
+  /// The angle is reduced to [-pi/4, pi/4] with pi/2 split in two parts, there the
+  /// Taylor series up to order 17 are exact to double precision. Branch free, so loops over it vectorise.
+  inline void periodic_sincos(const double& angle, double& sine, double& cosine)
+  {
+    const double half_pi_high = 1.57079632673412561417; // 33 significant bits, exact in products with small quadrants
+    const double half_pi_low = 6.07710050650619224932e-11;
+    const double quadrant = nearbyint(angle * (2. / M_PI));
+    const double r = (angle - quadrant * half_pi_high) - quadrant * half_pi_low;
+    const double r2 = r * r;
+
+    const double reduced_sine = r + r * r2 * (-1./6. + r2 * (1./120. + r2 * (-1./5040. + r2 * (1./362880. + r2 * (-1./39916800. + r2 * (1./6227020800. + r2 * (-1./1307674368000. + r2 * (1./355687428096000.))))))));
+    const double reduced_cosine = 1. + r2 * (-1./2. + r2 * (1./24. + r2 * (-1./720. + r2 * (1./40320. + r2 * (-1./3628800. + r2 * (1./479001600. + r2 * (-1./87178291200. + r2 * (1./20922789888000.))))))));
+
+    // quadrant q: sin(r + q pi/2) is sin, cos, -sin, -cos of r
+    const int q = static_cast<int> (quadrant);
+    const double swapped_sine = (q & 1) ? reduced_cosine : reduced_sine;
+    const double swapped_cosine = (q & 1) ? reduced_sine : reduced_cosine;
+    sine = (q & 2) ? -swapped_sine : swapped_sine;
+    cosine = ((q + 1) & 2) ? -swapped_cosine : swapped_cosine;
+  }
+
   inline CF_PSurface::CF_PSurface()
   {
   }
@@ -23,20 +45,35 @@ namespace mcchd
   inline CF_PSurface::CF_PSurface(const coordinate_type& new_extents)
   {
     extents = new_extents;
+    wave_numbers[0] = 2.*M_PI/extents[0];
+    wave_numbers[1] = 2.*M_PI/extents[1];
+    wave_numbers[2] = 2.*M_PI/extents[2];
   }
   
   inline CF_PSurface::~CF_PSurface()
   {
   }
+
+  inline double CF_PSurface::level_set(const double& x, const double& y, const double& z) const
+  {
+    double sin_x, cos_x, sin_y, cos_y, sin_z, cos_z;
+    periodic_sincos(wave_numbers[0] * x, sin_x, cos_x);
+    periodic_sincos(wave_numbers[1] * y, sin_y, cos_y);
+    periodic_sincos(wave_numbers[2] * z, sin_z, cos_z);
+    return cos_x + cos_y + cos_z;
+  }
   
   inline bool CF_PSurface::collides_with(const Disc& some_disc) const
   {
-    const Point disc_center = some_disc.get_center();
-    const double x = disc_center.get_coor(0);
-    const double y = disc_center.get_coor(1);
-    const double z = disc_center.get_coor(2);
-    bool overlaps = std::cos(2.*M_PI/extents[0] * x) + std::cos(2.*M_PI/extents[1] * y) + std::cos(2.*M_PI/extents[2] * z) < 0;
-    return overlaps;
+    const Point& disc_center = some_disc.get_center();
+    return level_set(disc_center.get_coor(0), disc_center.get_coor(1), disc_center.get_coor(2)) < 0;
+  }
+
+  /// collides_with for the count centers (xs[i], ys[i], zs[i])
+  inline void CF_PSurface::collides_with(const double* xs, const double* ys, const double* zs, const std::size_t& count, bool* collides) const
+  {
+    for (std::size_t idx = 0; idx < count; idx++)
+      collides[idx] = level_set(xs[idx], ys[idx], zs[idx]) < 0;
   }
 
 
@@ -47,25 +84,39 @@ namespace mcchd
   inline CF_DSurface::CF_DSurface(const coordinate_type& new_extents)
   {
     extents = new_extents;
+    wave_numbers[0] = 2.*M_PI/extents[0];
+    wave_numbers[1] = 2.*M_PI/extents[1];
+    wave_numbers[2] = 2.*M_PI/extents[2];
   }
   
   inline CF_DSurface::~CF_DSurface()
   {
   }
+
+  inline double CF_DSurface::level_set(const double& x, const double& y, const double& z) const
+  {
+    double sin_x, cos_x, sin_y, cos_y, sin_z, cos_z;
+    periodic_sincos(wave_numbers[0] * x, sin_x, cos_x);
+    periodic_sincos(wave_numbers[1] * y, sin_y, cos_y);
+    periodic_sincos(wave_numbers[2] * z, sin_z, cos_z);
+    return (sin_x * sin_y * sin_z +
+	    sin_x * cos_y * cos_z +
+	    cos_x * sin_y * cos_z +
+	    cos_x * cos_y * sin_z);
+  }
   
   inline bool CF_DSurface::collides_with(const Disc& some_disc) const
   {
-    const Point disc_center = some_disc.get_center();
-    const double x = disc_center.get_coor(0);
-    const double y = disc_center.get_coor(1);
-    const double z = disc_center.get_coor(2);
-    bool overlaps = (std::sin(2.*M_PI/extents[0] * x) * std::sin(2.*M_PI/extents[1] * y) * std::sin(2.*M_PI/extents[2] * z) +
-		     std::sin(2.*M_PI/extents[0] * x) * std::cos(2.*M_PI/extents[1] * y) * std::cos(2.*M_PI/extents[2] * z) +
-		     std::cos(2.*M_PI/extents[0] * x) * std::sin(2.*M_PI/extents[1] * y) * std::cos(2.*M_PI/extents[2] * z) +
-		     std::cos(2.*M_PI/extents[0] * x) * std::cos(2.*M_PI/extents[1] * y) * std::sin(2.*M_PI/extents[2] * z) ) < 0;
-    return overlaps;
+    const Point& disc_center = some_disc.get_center();
+    return level_set(disc_center.get_coor(0), disc_center.get_coor(1), disc_center.get_coor(2)) < 0;
   }
 
+  /// collides_with for the count centers (xs[i], ys[i], zs[i])
+  inline void CF_DSurface::collides_with(const double* xs, const double* ys, const double* zs, const std::size_t& count, bool* collides) const
+  {
+    for (std::size_t idx = 0; idx < count; idx++)
+      collides[idx] = level_set(xs[idx], ys[idx], zs[idx]) < 0;
+  }
 
 
   inline CF_GSurface::CF_GSurface()
@@ -75,24 +126,38 @@ namespace mcchd
   inline CF_GSurface::CF_GSurface(const coordinate_type& new_extents)
   {
     extents = new_extents;
+    wave_numbers[0] = 2.*M_PI/extents[0];
+    wave_numbers[1] = 2.*M_PI/extents[1];
+    wave_numbers[2] = 2.*M_PI/extents[2];
   }
   
   inline CF_GSurface::~CF_GSurface()
   {
   }
+
+  inline double CF_GSurface::level_set(const double& x, const double& y, const double& z) const
+  {
+    double sin_x, cos_x, sin_y, cos_y, sin_z, cos_z;
+    periodic_sincos(wave_numbers[0] * x, sin_x, cos_x);
+    periodic_sincos(wave_numbers[1] * y, sin_y, cos_y);
+    periodic_sincos(wave_numbers[2] * z, sin_z, cos_z);
+    return (cos_x * sin_y +
+	    cos_y * sin_z +
+	    cos_z * sin_x);
+  }
   
   inline bool CF_GSurface::collides_with(const Disc& some_disc) const
   {
-  const Point disc_center = some_disc.get_center();
-    const double x = disc_center.get_coor(0);
-    const double y = disc_center.get_coor(1);
-    const double z = disc_center.get_coor(2);
-    bool overlaps = (std::cos(2.*M_PI/extents[0] * x) * std::sin(2.*M_PI/extents[1] * y) +
-		     std::cos(2.*M_PI/extents[1] * y) * std::sin(2.*M_PI/extents[2] * z) +
-		     std::cos(2.*M_PI/extents[2] * z) * std::sin(2.*M_PI/extents[0] * x) ) < 0;
-    return overlaps;
+    const Point& disc_center = some_disc.get_center();
+    return level_set(disc_center.get_coor(0), disc_center.get_coor(1), disc_center.get_coor(2)) < 0;
   }
 
+  /// collides_with for the count centers (xs[i], ys[i], zs[i])
+  inline void CF_GSurface::collides_with(const double* xs, const double* ys, const double* zs, const std::size_t& count, bool* collides) const
+  {
+    for (std::size_t idx = 0; idx < count; idx++)
+      collides[idx] = level_set(xs[idx], ys[idx], zs[idx]) < 0;
+  }
 
 
   inline CF_InnerIWPSurface::CF_InnerIWPSurface()
@@ -102,25 +167,42 @@ namespace mcchd
   inline CF_InnerIWPSurface::CF_InnerIWPSurface(const coordinate_type& new_extents)
   {
     extents = new_extents;
+    wave_numbers[0] = 2.*M_PI/extents[0];
+    wave_numbers[1] = 2.*M_PI/extents[1];
+    wave_numbers[2] = 2.*M_PI/extents[2];
   }
   
   inline CF_InnerIWPSurface::~CF_InnerIWPSurface()
   {
   }
+
+  inline double CF_InnerIWPSurface::level_set(const double& x, const double& y, const double& z) const
+  {
+    double sin_x, cos_x, sin_y, cos_y, sin_z, cos_z;
+    periodic_sincos(wave_numbers[0] * x, sin_x, cos_x);
+    periodic_sincos(wave_numbers[1] * y, sin_y, cos_y);
+    periodic_sincos(wave_numbers[2] * z, sin_z, cos_z);
+    // cos(2 a) = 2 cos(a)^2 - 1
+    return 2*(cos_x * cos_y +
+	      cos_y * cos_z +
+	      cos_z * cos_x)
+      - (2. * (cos_x * cos_x + cos_y * cos_y + cos_z * cos_z) - 3.);
+  }
   
   inline bool CF_InnerIWPSurface::collides_with(const Disc& some_disc) const
   {
-    const Point disc_center = some_disc.get_center();
-    const double x = disc_center.get_coor(0);
-    const double y = disc_center.get_coor(1);
-    const double z = disc_center.get_coor(2);
-    bool overlaps = 2*(std::cos(2.*M_PI/extents[0] * x) * std::cos(2.*M_PI/extents[1] * y) +
-		       std::cos(2.*M_PI/extents[1] * y) * std::cos(2.*M_PI/extents[2] * z) +
-		       std::cos(2.*M_PI/extents[2] * z) * std::cos(2.*M_PI/extents[0] * x) )
-      - (std::cos(4.*M_PI/extents[0] * x) + std::cos(4.*M_PI/extents[1] * y) + std::cos(4.*M_PI/extents[2] * z)) < 0;
-    return overlaps;
+    const Point& disc_center = some_disc.get_center();
+    return level_set(disc_center.get_coor(0), disc_center.get_coor(1), disc_center.get_coor(2)) < 0;
   }
 
+  /// collides_with for the count centers (xs[i], ys[i], zs[i])
+  inline void CF_InnerIWPSurface::collides_with(const double* xs, const double* ys, const double* zs, const std::size_t& count, bool* collides) const
+  {
+    for (std::size_t idx = 0; idx < count; idx++)
+      collides[idx] = level_set(xs[idx], ys[idx], zs[idx]) < 0;
+  }
+
+
   inline CF_OuterIWPSurface::CF_OuterIWPSurface()
   {
   }
@@ -128,23 +210,39 @@ namespace mcchd
   inline CF_OuterIWPSurface::CF_OuterIWPSurface(const coordinate_type& new_extents)
   {
     extents = new_extents;
+    wave_numbers[0] = 2.*M_PI/extents[0];
+    wave_numbers[1] = 2.*M_PI/extents[1];
+    wave_numbers[2] = 2.*M_PI/extents[2];
   }
   
   inline CF_OuterIWPSurface::~CF_OuterIWPSurface()
   {
   }
+
+  inline double CF_OuterIWPSurface::level_set(const double& x, const double& y, const double& z) const
+  {
+    double sin_x, cos_x, sin_y, cos_y, sin_z, cos_z;
+    periodic_sincos(wave_numbers[0] * x, sin_x, cos_x);
+    periodic_sincos(wave_numbers[1] * y, sin_y, cos_y);
+    periodic_sincos(wave_numbers[2] * z, sin_z, cos_z);
+    // cos(2 a) = 2 cos(a)^2 - 1
+    return 2*(cos_x * cos_y +
+	      cos_y * cos_z +
+	      cos_z * cos_x)
+      - (2. * (cos_x * cos_x + cos_y * cos_y + cos_z * cos_z) - 3.);
+  }
   
   inline bool CF_OuterIWPSurface::collides_with(const Disc& some_disc) const
   {
-    const Point disc_center = some_disc.get_center();
-    const double x = disc_center.get_coor(0);
-    const double y = disc_center.get_coor(1);
-    const double z = disc_center.get_coor(2);
-    bool overlaps = 2*(std::cos(2.*M_PI/extents[0] * x) * std::cos(2.*M_PI/extents[1] * y) +
-		       std::cos(2.*M_PI/extents[1] * y) * std::cos(2.*M_PI/extents[2] * z) +
-		       std::cos(2.*M_PI/extents[2] * z) * std::cos(2.*M_PI/extents[0] * x) )
-      - (std::cos(4.*M_PI/extents[0] * x) + std::cos(4.*M_PI/extents[1] * y) + std::cos(4.*M_PI/extents[2] * z)) > 0;
-    return overlaps;
+    const Point& disc_center = some_disc.get_center();
+    return level_set(disc_center.get_coor(0), disc_center.get_coor(1), disc_center.get_coor(2)) > 0;
+  }
+
+  /// collides_with for the count centers (xs[i], ys[i], zs[i])
+  inline void CF_OuterIWPSurface::collides_with(const double* xs, const double* ys, const double* zs, const std::size_t& count, bool* collides) const
+  {
+    for (std::size_t idx = 0; idx < count; idx++)
+      collides[idx] = level_set(xs[idx], ys[idx], zs[idx]) > 0;
   }
 
 
@@ -9,6 +9,13 @@
  *  - D
  *  - G
  *  - IWP
+ *
+ * The level sets are evaluated from one sine and cosine per axis, taken
+ * from periodic_sincos with the wave numbers 2 pi / L precomputed. Its
+ * absolute error stays below 1e-15, so a disc is classified differently
+ * from the std::sin/std::cos formulas only within about 1e-14 of the
+ * surface. The batch collides_with evaluates many centers in one loop the
+ * compiler can vectorise.
  * 
  * \author Johannes Knauf
  */
@@ -16,59 +23,78 @@
 #ifndef COLLISIONFUNCTOR_NODALSURFACES_HPP
 #define COLLISIONFUNCTOR_NODALSURFACES_HPP
 
+#include <cstddef>
+
 #include <Point.hpp>
 #include <Disc.hpp>
 
 namespace mcchd
 {
+  void periodic_sincos(const double&, double&, double&);
+
   class CF_PSurface {
   private:
     coordinate_type extents;
+    coordinate_type wave_numbers; /// 2 pi / extents
+    double level_set(const double&, const double&, const double&) const;
   public:
     CF_PSurface();
     CF_PSurface(const coordinate_type&);
     ~CF_PSurface();
     bool collides_with(const Disc&) const;
+    void collides_with(const double*, const double*, const double*, const std::size_t&, bool*) const;
   };
 
   class CF_DSurface {
   private:
     coordinate_type extents;
+    coordinate_type wave_numbers; /// 2 pi / extents
+    double level_set(const double&, const double&, const double&) const;
   public:
     CF_DSurface();
     CF_DSurface(const coordinate_type&);
     ~CF_DSurface();
     bool collides_with(const Disc&) const;
+    void collides_with(const double*, const double*, const double*, const std::size_t&, bool*) const;
   };
 
   class CF_GSurface {
   private:
     coordinate_type extents;
+    coordinate_type wave_numbers; /// 2 pi / extents
+    double level_set(const double&, const double&, const double&) const;
   public:
     CF_GSurface();
     CF_GSurface(const coordinate_type&);
     ~CF_GSurface();
     bool collides_with(const Disc&) const;
+    void collides_with(const double*, const double*, const double*, const std::size_t&, bool*) const;
   };
 
   class CF_InnerIWPSurface {
   private:
     coordinate_type extents;
+    coordinate_type wave_numbers; /// 2 pi / extents
+    double level_set(const double&, const double&, const double&) const;
   public:
     CF_InnerIWPSurface();
     CF_InnerIWPSurface(const coordinate_type&);
     ~CF_InnerIWPSurface();
     bool collides_with(const Disc&) const;
+    void collides_with(const double*, const double*, const double*, const std::size_t&, bool*) const;
   };
 
   class CF_OuterIWPSurface {
   private:
     coordinate_type extents;
+    coordinate_type wave_numbers; /// 2 pi / extents
+    double level_set(const double&, const double&, const double&) const;
   public:
     CF_OuterIWPSurface();
     CF_OuterIWPSurface(const coordinate_type&);
     ~CF_OuterIWPSurface();
     bool collides_with(const Disc&) const;
+    void collides_with(const double*, const double*, const double*, const std::size_t&, bool*) const;
   };
 
 }
@@ -0,0 +1,124 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file CollisionFunctor_Voxelized.cpp
+ * \brief Voxel table in front of any collision functor
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef COLLISIONFUNCTOR_VOXELIZED_HPP
+
+#include <algorithm>
+
+#include <cmath>
+
+
+namespace mcchd
+{
+  template <class CollisionFunctor>
+  inline index_type CF_Voxelized<CollisionFunctor>::get_voxel_idx(const index_type& i_idx, const index_type& j_idx, const index_type& k_idx) const
+  {
+    return (i_idx * num_voxels[1] + j_idx) * num_voxels[2] + k_idx;
+  }
+
+  template <class CollisionFunctor>
+  inline CF_Voxelized<CollisionFunctor>::CF_Voxelized()
+  {
+  }
+
+  template <class CollisionFunctor>
+  inline CF_Voxelized<CollisionFunctor>::CF_Voxelized(const coordinate_type& new_extents, const double& max_voxel_scale) : exact_container(new_extents)
+  {
+    extents = new_extents;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	num_voxels[axis] = std::max(static_cast<index_type> (ceil(extents[axis] / max_voxel_scale)), static_cast<index_type> (1));
+	voxel_scale[axis] = extents[axis] / num_voxels[axis];
+      }
+
+    // the exact functor at every voxel corner
+    const index_type i_corners = num_voxels[0] + 1;
+    const index_type j_corners = num_voxels[1] + 1;
+    const index_type k_corners = num_voxels[2] + 1;
+    std::vector<uint8_t> corner_collides(i_corners * j_corners * k_corners);
+    for (index_type i = 0; i < i_corners; i++)
+      for (index_type j = 0; j < j_corners; j++)
+	for (index_type k = 0; k < k_corners; k++)
+	  {
+	    const Disc corner_disc(Point(i * voxel_scale[0], j * voxel_scale[1], k * voxel_scale[2]), no_disc);
+	    corner_collides[(i * j_corners + j) * k_corners + k] = exact_container.collides_with(corner_disc);
+	  }
+
+    // voxels with disagreeing corners are crossed by the boundary
+    std::vector<uint8_t> crossed_voxels(num_voxels[0] * num_voxels[1] * num_voxels[2]);
+    voxel_states.resize(crossed_voxels.size());
+    for (index_type i = 0; i < num_voxels[0]; i++)
+      for (index_type j = 0; j < num_voxels[1]; j++)
+	for (index_type k = 0; k < num_voxels[2]; k++)
+	  {
+	    uint8_t colliding_corners = 0;
+	    for (index_type corner = 0; corner < 8; corner++)
+	      colliding_corners += corner_collides[((i + (corner >> 2)) * j_corners + j + ((corner >> 1) & 1)) * k_corners + k + (corner & 1)];
+
+	    const index_type voxel_idx = get_voxel_idx(i, j, k);
+	    crossed_voxels[voxel_idx] = (colliding_corners != 0 && colliding_corners != 8);
+	    voxel_states[voxel_idx] = (colliding_corners == 8) ? voxel_forbidden : voxel_allowed;
+	  }
+
+    // the boundary may pass a voxel between its corners, so the neighbours of crossed voxels are boundary as well
+    for (index_type i = 0; i < num_voxels[0]; i++)
+      for (index_type j = 0; j < num_voxels[1]; j++)
+	for (index_type k = 0; k < num_voxels[2]; k++)
+	  {
+	    if (! crossed_voxels[get_voxel_idx(i, j, k)])
+	      continue;
+	    for (index_type di = 0; di < 3; di++)
+	      for (index_type dj = 0; dj < 3; dj++)
+		for (index_type dk = 0; dk < 3; dk++)
+		  voxel_states[get_voxel_idx((i + num_voxels[0] + di - 1) % num_voxels[0],
+					     (j + num_voxels[1] + dj - 1) % num_voxels[1],
+					     (k + num_voxels[2] + dk - 1) % num_voxels[2])] = voxel_boundary;
+	  }
+  }
+
+  template <class CollisionFunctor>
+  inline CF_Voxelized<CollisionFunctor>::~CF_Voxelized()
+  {
+  }
+
+  /// share of the voxels which need the exact functor
+  template <class CollisionFunctor>
+  inline double CF_Voxelized<CollisionFunctor>::get_boundary_fraction() const
+  {
+    return std::count(voxel_states.begin(), voxel_states.end(), static_cast<uint8_t> (voxel_boundary)) / static_cast<double> (voxel_states.size());
+  }
+
+  template <class CollisionFunctor>
+  inline bool CF_Voxelized<CollisionFunctor>::collides_with(const Disc& some_disc) const
+  {
+    const Point& disc_center = some_disc.get_center();
+    multi_index_type voxel_idx;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const double coor = disc_center.get_coor(axis);
+	// outside the table, only the exact functor knows
+	if (! (coor >= 0. && coor < extents[axis]))
+	  return exact_container.collides_with(some_disc);
+	voxel_idx[axis] = std::min(static_cast<index_type> (coor / voxel_scale[axis]), num_voxels[axis] - 1);
+      }
+
+    switch (voxel_states[get_voxel_idx(voxel_idx[0], voxel_idx[1], voxel_idx[2])])
+      {
+      case voxel_allowed:
+	return false;
+      case voxel_forbidden:
+	return true;
+      default:
+	return exact_container.collides_with(some_disc);
+      }
+  }
+
+}
+
+#endif
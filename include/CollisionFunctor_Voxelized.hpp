@@ -0,0 +1,59 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file CollisionFunctor_Voxelized.hpp
+ * \brief Voxel table in front of any collision functor -- header
+ *
+ * CF_Voxelized<CF> splits the box into voxels of at most voxel_scale and
+ * evaluates CF once at every voxel corner. A voxel whose corners all
+ * collide is forbidden, one whose corners are all free is allowed, any
+ * other voxel and its neighbours are boundary. collides_with answers from
+ * the table and asks CF only in boundary voxels.
+ *
+ * The answers equal those of CF as long as its allowed and forbidden
+ * regions have no features thinner than a voxel, which holds for all
+ * containers of this project at the default scale.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef COLLISIONFUNCTOR_VOXELIZED_HPP
+#define COLLISIONFUNCTOR_VOXELIZED_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd
+{
+  const double default_voxel_scale = 0.1;
+
+  enum voxel_state_type { voxel_allowed = 0, voxel_forbidden = 1, voxel_boundary = 2 };
+
+  template <class CollisionFunctor>
+  class CF_Voxelized {
+  private:
+    CollisionFunctor exact_container;
+    coordinate_type extents;
+    coordinate_type voxel_scale;
+    multi_index_type num_voxels;
+    std::vector<uint8_t> voxel_states; /// row major, one voxel_state_type per voxel
+
+    index_type get_voxel_idx(const index_type&, const index_type&, const index_type&) const;
+  public:
+    CF_Voxelized();
+    CF_Voxelized(const coordinate_type&, const double& = default_voxel_scale);
+    ~CF_Voxelized();
+    double get_boundary_fraction() const;
+    bool collides_with(const Disc&) const;
+  };
+
+}
+
+
+#include <CollisionFunctor_Voxelized.cpp>
+
+#endif
@@ -0,0 +1,60 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file ContainerDispatch.cpp
+ * \brief Runtime selection of the container -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef CONTAINERDISPATCH_HPP
+
+namespace mcchd
+{
+  /// runs with the container itself or with a voxel table in front of it
+  template <class CollisionFunctor, class Runner>
+  inline void dispatch_voxelized(const bool& voxelized, Runner& runner)
+  {
+    if (voxelized)
+      runner.template run<CF_Voxelized<CollisionFunctor> >();
+    else
+      runner.template run<CollisionFunctor>();
+  }
+
+  /// calls runner.run<CollisionFunctor>() for the container of that name, voxelized if requested
+  template <class Runner>
+  inline void dispatch_container(const std::string& container_name, const bool& voxelized, Runner& runner)
+  {
+    if (container_name == "Bulk")
+      dispatch_voxelized<CF_Bulk>(voxelized, runner);
+    else if (container_name == "PointDefect")
+      dispatch_voxelized<CF_PointDefect>(voxelized, runner);
+    else if (container_name == "LineDefect")
+      dispatch_voxelized<CF_LineDefect>(voxelized, runner);
+    else if (container_name == "PlaneDefect")
+      dispatch_voxelized<CF_PlaneDefect>(voxelized, runner);
+    else if (container_name == "InnerSphere")
+      dispatch_voxelized<CF_InnerSphere>(voxelized, runner);
+    else if (container_name == "OuterSphere")
+      dispatch_voxelized<CF_OuterSphere>(voxelized, runner);
+    else if (container_name == "InnerCylinder")
+      dispatch_voxelized<CF_InnerCylinder>(voxelized, runner);
+    else if (container_name == "OuterCylinder")
+      dispatch_voxelized<CF_OuterCylinder>(voxelized, runner);
+    else if (container_name == "PSurface")
+      dispatch_voxelized<CF_PSurface>(voxelized, runner);
+    else if (container_name == "DSurface")
+      dispatch_voxelized<CF_DSurface>(voxelized, runner);
+    else if (container_name == "GSurface")
+      dispatch_voxelized<CF_GSurface>(voxelized, runner);
+    else if (container_name == "InnerIWPSurface")
+      dispatch_voxelized<CF_InnerIWPSurface>(voxelized, runner);
+    else if (container_name == "OuterIWPSurface")
+      dispatch_voxelized<CF_OuterIWPSurface>(voxelized, runner);
+    else
+      throw unknown_container_exception();
+  }
+
+}
+
+#endif
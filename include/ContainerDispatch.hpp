@@ -0,0 +1,47 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file ContainerDispatch.hpp
+ * \brief Runtime selection of the container -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * dispatch_container maps a container name, e.g. from --container, to its
+ * CollisionFunctor type and calls runner.run<CollisionFunctor>() once. The
+ * simulation below is instantiated for every container, so the hot loop
+ * sees the concrete type and no virtual calls.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef CONTAINERDISPATCH_HPP
+#define CONTAINERDISPATCH_HPP
+
+#include <string>
+#include <exception>
+
+#include <CollisionFunctor_SingularDefects.hpp>
+#include <CollisionFunctor_SimpleGeometries.hpp>
+#include <CollisionFunctor_NodalSurfaces.hpp>
+#include <CollisionFunctor_Voxelized.hpp>
+
+namespace mcchd
+{
+  /// names accepted by dispatch_container, for help messages
+  const char* const container_names = "Bulk, PointDefect, LineDefect, PlaneDefect, InnerSphere, OuterSphere, InnerCylinder, OuterCylinder, PSurface, DSurface, GSurface, InnerIWPSurface, OuterIWPSurface";
+
+  class unknown_container_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "Unknown container name, --help lists the possible containers.";
+    }
+  };
+
+  template <class Runner> void dispatch_container(const std::string&, const bool&, Runner&);
+
+}
+
+#include <ContainerDispatch.cpp>
+
+#endif
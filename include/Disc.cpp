@@ -43,6 +43,11 @@ namespace mcchd {
     return center;
   }
 
+  inline const disc_id_type& Disc::get_id() const
+  {
+    return id;
+  }
+
   inline void Disc::translate_to(const Point& new_center)
   {
     center = new_center;
@@ -18,6 +18,8 @@ namespace mcchd {
 
   const double DEFAULT_DISC_RADIUS = 0.5;
   typedef uint32_t disc_id_type;
+  /// id of a disc which is not part of any configuration, e.g. a test disc
+  const disc_id_type no_disc = -1;
 
   class Disc {
   private:
@@ -30,6 +32,7 @@ namespace mcchd {
     Disc(const Point&, const disc_id_type&);
     ~Disc();
     const Point& get_center() const;
+    const disc_id_type& get_id() const;
     void translate_to(const Point&);
     double distance(const Disc&) const;
     double distance(const Disc&, const coordinate_type&) const;
@@ -0,0 +1,129 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file DiscPositions.cpp
+ * \brief Structure of arrays storage for disc centers -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef DISCPOSITIONS_HPP
+
+#include <algorithm>
+
+#include <cassert>
+
+namespace mcchd {
+
+  inline DiscPositions::DiscPositions() : num_present(0)
+  {
+  }
+
+  inline DiscPositions::DiscPositions(const disc_id_type& capacity, const coordinate_type& new_extents) : num_present(0), extents(new_extents)
+  {
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      coors[axis].resize(capacity, 0.);
+  }
+
+  inline DiscPositions::~DiscPositions()
+  {
+  }
+
+  inline const disc_id_type& DiscPositions::get_number_of_discs() const
+  {
+    return num_present;
+  }
+
+  inline disc_id_type DiscPositions::get_capacity() const
+  {
+    return coors[0].size();
+  }
+
+  /// contiguous coordinates along axis, valid up to get_number_of_discs()
+  inline const double* DiscPositions::get_coors(const uint8_t& axis) const
+  {
+    return &(coors[axis][0]);
+  }
+
+  inline Point DiscPositions::get_center(const disc_id_type& disc_idx) const
+  {
+    return Point(coors[0][disc_idx], coors[1][disc_idx], coors[2][disc_idx]);
+  }
+
+  /// the centers are stored as points
+  inline DiscPositions::stored_center_type DiscPositions::get_stored_center(const disc_id_type& disc_idx) const
+  {
+    return get_center(disc_idx);
+  }
+
+  /// center of the disc after the displacement, wrapped back into the box
+  inline DiscPositions::stored_center_type DiscPositions::get_displaced_stored_center(const disc_id_type& disc_idx, const Point& displacement) const
+  {
+    Point displaced_center = get_center(disc_idx) + displacement;
+    displaced_center.rebase_periodic(extents);
+    return displaced_center;
+  }
+
+  inline DiscPositions::stored_center_type DiscPositions::to_stored_center(const Point& center) const
+  {
+    return center;
+  }
+
+  inline Point DiscPositions::to_point(const stored_center_type& stored_center) const
+  {
+    return stored_center;
+  }
+
+  inline void DiscPositions::set_center(const disc_id_type& disc_idx, const Point& new_center)
+  {
+    coors[0][disc_idx] = new_center.get_coor(0);
+    coors[1][disc_idx] = new_center.get_coor(1);
+    coors[2][disc_idx] = new_center.get_coor(2);
+  }
+
+  inline void DiscPositions::set_stored_center(const disc_id_type& disc_idx, const stored_center_type& new_center)
+  {
+    set_center(disc_idx, new_center);
+  }
+
+  /// places a disc at the first unused index and returns that index
+  inline disc_id_type DiscPositions::append(const Point& new_center)
+  {
+    assert(num_present < get_capacity());
+    const disc_id_type new_idx = num_present;
+    set_center(new_idx, new_center);
+    num_present += 1;
+    return new_idx;
+  }
+
+  /// swaps the disc with the last present one and takes it out of the system
+  inline void DiscPositions::swap_remove(const disc_id_type& disc_idx)
+  {
+    assert(disc_idx < num_present);
+    const disc_id_type last_idx = num_present - 1;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      std::swap(coors[axis][disc_idx], coors[axis][last_idx]);
+    num_present -= 1;
+  }
+
+
+  template <class Positions>
+  inline DiscOverlapPredicate<Positions>::DiscOverlapPredicate(const Positions& new_positions, const Disc& new_test_disc, const coordinate_type& new_extents) : positions(new_positions), test_disc(new_test_disc), extents(new_extents)
+  {
+  }
+
+  template <class Positions>
+  inline bool DiscOverlapPredicate<Positions>::operator()(const disc_id_type& disc_idx) const
+  {
+    return (*this)(disc_idx, positions.get_center(disc_idx));
+  }
+
+  template <class Positions>
+  inline bool DiscOverlapPredicate<Positions>::operator()(const disc_id_type& disc_idx, const Point& disc_center) const
+  {
+    return (disc_idx != test_disc.get_id()) && is_overlapping_periodic(test_disc.get_center(), disc_center, extents);
+  }
+
+}
+
+#endif
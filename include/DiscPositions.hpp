@@ -0,0 +1,110 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file DiscPositions.hpp
+ * \brief Structure of arrays storage for disc centers
+ *
+ * Pure helper class for HardDiscs implementarion
+ *
+ * All discs share DEFAULT_DISC_RADIUS, so a disc is fully described by
+ * its index and its center. The centers are kept in one contiguous array
+ * per axis, the lookup tables refer to discs by index.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef DISCPOSITIONS_HPP
+#define DISCPOSITIONS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/array.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/split_member.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <OverlapKernel.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  class DiscPositions
+  {
+  private:
+    /// each axis is divided in 2 halves:
+    ///  1st half (til idx == num_present): Disc is in the system
+    ///  2nd half (including and above idx == num_present): Disc is out of the system
+    boost::array<std::vector<double>, dimensions> coors;
+    disc_id_type num_present;
+    coordinate_type extents;
+
+  public:
+    /// center as handed to the lookup table
+    typedef Point stored_center_type;
+
+    DiscPositions();
+    DiscPositions(const disc_id_type&, const coordinate_type&);
+    ~DiscPositions();
+    const disc_id_type& get_number_of_discs() const;
+    disc_id_type get_capacity() const;
+    const double* get_coors(const uint8_t&) const;
+    Point get_center(const disc_id_type&) const;
+    stored_center_type get_stored_center(const disc_id_type&) const;
+    stored_center_type get_displaced_stored_center(const disc_id_type&, const Point&) const;
+    stored_center_type to_stored_center(const Point&) const;
+    Point to_point(const stored_center_type&) const;
+    void set_center(const disc_id_type&, const Point&);
+    void set_stored_center(const disc_id_type&, const stored_center_type&);
+    disc_id_type append(const Point&);
+    void swap_remove(const disc_id_type&);
+
+    /// capacity, extents and the centers of the present discs
+    template<class Archive> void save(Archive & ar, const unsigned int) const
+    {
+      const disc_id_type capacity = get_capacity();
+      ar & capacity;
+      ar & boost::serialization::make_array(extents.data(), dimensions);
+      ar & num_present;
+      for (uint8_t axis = 0; axis < dimensions; axis++)
+	ar & boost::serialization::make_array(coors[axis].data(), num_present);
+    }
+
+    template<class Archive> void load(Archive & ar, const unsigned int)
+    {
+      disc_id_type capacity;
+      coordinate_type new_extents;
+      ar & capacity;
+      ar & boost::serialization::make_array(new_extents.data(), dimensions);
+      *this = DiscPositions(capacity, new_extents);
+      ar & num_present;
+      for (uint8_t axis = 0; axis < dimensions; axis++)
+	ar & boost::serialization::make_array(coors[axis].data(), num_present);
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+  };
+
+  /// true for every stored disc other than the test disc which overlaps the test disc -- predicate for the any_overlap query of the lookup tables
+  /// Tables which keep the disc centers themselves pass the center along, the others only the index.
+  /// Positions is DiscPositions or DiscPositions_FixedPoint.
+  template <class Positions = DiscPositions>
+  class DiscOverlapPredicate
+  {
+  private:
+    const Positions& positions;
+    const Disc& test_disc;
+    const coordinate_type& extents;
+  public:
+    DiscOverlapPredicate(const Positions&, const Disc&, const coordinate_type&);
+    bool operator()(const disc_id_type&) const;
+    bool operator()(const disc_id_type&, const Point&) const;
+  };
+
+}
+
+#include <DiscPositions.cpp>
+
+#endif
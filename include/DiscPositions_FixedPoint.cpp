@@ -0,0 +1,131 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file DiscPositions_FixedPoint.cpp
+ * \brief Storage for disc centers -- fixed point implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef DISCPOSITIONS_FIXEDPOINT_HPP
+
+#include <algorithm>
+
+#include <cassert>
+#include <cmath>
+
+namespace mcchd {
+
+  /// 2^32 as double, the number of fixed point steps along an axis
+  const double fixed_steps_per_extent = 4294967296.;
+  /// 2^33 + 1/2, makes every coordinate down to minus two extents positive, so truncation rounds to nearest
+  const double fixed_rounding_offset = 8589934592.5;
+
+  /// nearest fixed point value, taken modulo the extent -- so small negative coordinates and the extent itself wrap as well
+  /// The offset is a multiple of the extent and drops out of the 32 bits, no floor needed.
+  inline fixed_coor_type DiscPositions_FixedPoint::to_fixed(const double& coor, const uint8_t& axis) const
+  {
+    return static_cast<fixed_coor_type> (static_cast<int64_t> (coor * fixed_inverse_scale[axis] + fixed_rounding_offset));
+  }
+
+  inline DiscPositions_FixedPoint::DiscPositions_FixedPoint() : num_present(0)
+  {
+  }
+
+  inline DiscPositions_FixedPoint::DiscPositions_FixedPoint(const disc_id_type& capacity, const coordinate_type& new_extents) : num_present(0), extents(new_extents)
+  {
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	coors[axis].resize(capacity, 0);
+	fixed_scale[axis] = extents[axis] / fixed_steps_per_extent;
+	fixed_inverse_scale[axis] = fixed_steps_per_extent / extents[axis];
+      }
+  }
+
+  inline DiscPositions_FixedPoint::~DiscPositions_FixedPoint()
+  {
+  }
+
+  inline const disc_id_type& DiscPositions_FixedPoint::get_number_of_discs() const
+  {
+    return num_present;
+  }
+
+  inline disc_id_type DiscPositions_FixedPoint::get_capacity() const
+  {
+    return coors[0].size();
+  }
+
+  /// contiguous fixed point coordinates along axis, valid up to get_number_of_discs()
+  inline const fixed_coor_type* DiscPositions_FixedPoint::get_coors(const uint8_t& axis) const
+  {
+    return &(coors[axis][0]);
+  }
+
+  inline Point DiscPositions_FixedPoint::get_center(const disc_id_type& disc_idx) const
+  {
+    return to_point(get_stored_center(disc_idx));
+  }
+
+  inline DiscPositions_FixedPoint::stored_center_type DiscPositions_FixedPoint::get_stored_center(const disc_id_type& disc_idx) const
+  {
+    const stored_center_type stored_center = {{coors[0][disc_idx], coors[1][disc_idx], coors[2][disc_idx]}};
+    return stored_center;
+  }
+
+  /// the displacement is rounded to the fixed point grid, the sum wraps around the box by integer overflow
+  /// Displacements have to be shorter than half the extent.
+  inline DiscPositions_FixedPoint::stored_center_type DiscPositions_FixedPoint::get_displaced_stored_center(const disc_id_type& disc_idx, const Point& displacement) const
+  {
+    const stored_center_type displaced_center = {{static_cast<fixed_coor_type> (coors[0][disc_idx] + to_fixed(displacement.get_coor(0), 0)),
+						  static_cast<fixed_coor_type> (coors[1][disc_idx] + to_fixed(displacement.get_coor(1), 1)),
+						  static_cast<fixed_coor_type> (coors[2][disc_idx] + to_fixed(displacement.get_coor(2), 2))}};
+    return displaced_center;
+  }
+
+  inline DiscPositions_FixedPoint::stored_center_type DiscPositions_FixedPoint::to_stored_center(const Point& center) const
+  {
+    const stored_center_type stored_center = {{to_fixed(center.get_coor(0), 0), to_fixed(center.get_coor(1), 1), to_fixed(center.get_coor(2), 2)}};
+    return stored_center;
+  }
+
+  inline Point DiscPositions_FixedPoint::to_point(const stored_center_type& stored_center) const
+  {
+    return Point(stored_center[0] * fixed_scale[0], stored_center[1] * fixed_scale[1], stored_center[2] * fixed_scale[2]);
+  }
+
+  inline void DiscPositions_FixedPoint::set_center(const disc_id_type& disc_idx, const Point& new_center)
+  {
+    set_stored_center(disc_idx, to_stored_center(new_center));
+  }
+
+  inline void DiscPositions_FixedPoint::set_stored_center(const disc_id_type& disc_idx, const stored_center_type& new_center)
+  {
+    coors[0][disc_idx] = new_center[0];
+    coors[1][disc_idx] = new_center[1];
+    coors[2][disc_idx] = new_center[2];
+  }
+
+  /// places a disc at the first unused index and returns that index
+  inline disc_id_type DiscPositions_FixedPoint::append(const Point& new_center)
+  {
+    assert(num_present < get_capacity());
+    const disc_id_type new_idx = num_present;
+    set_center(new_idx, new_center);
+    num_present += 1;
+    return new_idx;
+  }
+
+  /// swaps the disc with the last present one and takes it out of the system
+  inline void DiscPositions_FixedPoint::swap_remove(const disc_id_type& disc_idx)
+  {
+    assert(disc_idx < num_present);
+    const disc_id_type last_idx = num_present - 1;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      std::swap(coors[axis][disc_idx], coors[axis][last_idx]);
+    num_present -= 1;
+  }
+
+}
+
+#endif
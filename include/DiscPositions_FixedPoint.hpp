@@ -0,0 +1,100 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file DiscPositions_FixedPoint.hpp
+ * \brief Storage for disc centers -- fixed point version
+ *
+ * Pure helper class for HardDiscs implementarion
+ *
+ * Same interface as DiscPositions. Each coordinate is kept as an unsigned
+ * 32 bit fraction of the box extent, coordinate = fixed * extent / 2^32.
+ * The periodic wrap of a displaced disc is the integer overflow of the
+ * addition, no loops and no fmod. The resolution is extent / 2^32, about
+ * 1e-9 for a box of edge 5.
+ *
+ * The lookup tables are handed the stored center, the fixed point
+ * coordinates themselves, and find the cell from their top bits.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef DISCPOSITIONS_FIXEDPOINT_HPP
+#define DISCPOSITIONS_FIXEDPOINT_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/array.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/split_member.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  class DiscPositions_FixedPoint
+  {
+  private:
+    /// each axis is divided in 2 halves, as in DiscPositions
+    boost::array<std::vector<fixed_coor_type>, dimensions> coors;
+    disc_id_type num_present;
+    coordinate_type extents;
+    coordinate_type fixed_scale; /// extent / 2^32, length of one fixed point step
+    coordinate_type fixed_inverse_scale; /// 2^32 / extent
+
+    fixed_coor_type to_fixed(const double&, const uint8_t&) const;
+
+  public:
+    /// center as handed to the lookup table
+    typedef fixed_coordinate_type stored_center_type;
+
+    DiscPositions_FixedPoint();
+    DiscPositions_FixedPoint(const disc_id_type&, const coordinate_type&);
+    ~DiscPositions_FixedPoint();
+    const disc_id_type& get_number_of_discs() const;
+    disc_id_type get_capacity() const;
+    const fixed_coor_type* get_coors(const uint8_t&) const;
+    Point get_center(const disc_id_type&) const;
+    stored_center_type get_stored_center(const disc_id_type&) const;
+    stored_center_type get_displaced_stored_center(const disc_id_type&, const Point&) const;
+    stored_center_type to_stored_center(const Point&) const;
+    Point to_point(const stored_center_type&) const;
+    void set_center(const disc_id_type&, const Point&);
+    void set_stored_center(const disc_id_type&, const stored_center_type&);
+    disc_id_type append(const Point&);
+    void swap_remove(const disc_id_type&);
+
+    /// capacity, extents and the centers of the present discs
+    template<class Archive> void save(Archive & ar, const unsigned int) const
+    {
+      const disc_id_type capacity = get_capacity();
+      ar & capacity;
+      ar & boost::serialization::make_array(extents.data(), dimensions);
+      ar & num_present;
+      for (uint8_t axis = 0; axis < dimensions; axis++)
+	ar & boost::serialization::make_array(coors[axis].data(), num_present);
+    }
+
+    template<class Archive> void load(Archive & ar, const unsigned int)
+    {
+      disc_id_type capacity;
+      coordinate_type new_extents;
+      ar & capacity;
+      ar & boost::serialization::make_array(new_extents.data(), dimensions);
+      *this = DiscPositions_FixedPoint(capacity, new_extents);
+      ar & num_present;
+      for (uint8_t axis = 0; axis < dimensions; axis++)
+	ar & boost::serialization::make_array(coors[axis].data(), num_present);
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+  };
+
+}
+
+#include <DiscPositions_FixedPoint.cpp>
+
+#endif
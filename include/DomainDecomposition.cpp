@@ -0,0 +1,308 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file DomainDecomposition.cpp
+ * \brief Grand canonical sweeps of hard discs split over MPI ranks -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef DOMAINDECOMPOSITION_HPP
+
+#include <cmath>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/nonblocking.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <SeedMixing.hpp>
+
+namespace mcchd
+{
+  /// message tags, a message travelling to the left neighbour takes the even tag, to the right one the odd tag
+  const int migration_tag = 0;
+  const int halo_tag = 2;
+  const int dimensions_per_disc = dimensions;
+
+  /// new_configuration has to hold the same initial configuration on every rank, each rank keeps the discs of its slab
+  template <class Configuration, class RandomNumberGenerator>
+  inline DomainDecomposition<Configuration, RandomNumberGenerator>::DomainDecomposition(const boost::mpi::communicator& new_communicator, Configuration* new_configuration, const uint32_t& seed)
+    : communicator(new_communicator), configuration(new_configuration), extents(new_configuration->get_extents()), slab_offset(0.)
+  {
+    rank = communicator.rank();
+    num_ranks = communicator.size();
+    left_rank = (rank + num_ranks - 1) % num_ranks;
+    right_rank = (rank + 1) % num_ranks;
+    slab_width = extents[0] / num_ranks;
+    if (num_ranks > 1 && slab_width <= 2. * halo_depth)
+      throw bad_slabs_exception();
+
+    offset_rng.set_seed(mix_seed(seed, num_ranks));
+    step_rng.set_seed(mix_seed(seed, rank));
+
+    remove_ghosts();
+    exchange_halos();
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline DomainDecomposition<Configuration, RandomNumberGenerator>::~DomainDecomposition()
+  {
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline const int& DomainDecomposition<Configuration, RandomNumberGenerator>::get_rank() const
+  {
+    return rank;
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline const int& DomainDecomposition<Configuration, RandomNumberGenerator>::get_num_ranks() const
+  {
+    return num_ranks;
+  }
+
+  /// x measured from the lower boundary of the slab of rank 0
+  template <class Configuration, class RandomNumberGenerator>
+  inline double DomainDecomposition<Configuration, RandomNumberGenerator>::get_slab_coor(const Point& point) const
+  {
+    const double slab_coor = point.get_coor(0) - slab_offset;
+    return (slab_coor < 0.) ? slab_coor + extents[0] : slab_coor;
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline int DomainDecomposition<Configuration, RandomNumberGenerator>::get_owner(const Point& point) const
+  {
+    const int owner = static_cast<int> (floor(get_slab_coor(point) / slab_width));
+    return (owner < num_ranks) ? owner : num_ranks - 1;
+  }
+
+  /// from the top, as a removal moves the last disc into the place of the removed one
+  template <class Configuration, class RandomNumberGenerator>
+  inline void DomainDecomposition<Configuration, RandomNumberGenerator>::remove_ghosts()
+  {
+    for (disc_id_type disc_idx = configuration->get_number_of_discs(); disc_idx > 0; disc_idx--)
+      if (get_owner(configuration->get_disc_center(disc_idx - 1)) != rank)
+	configuration->remove_disc(disc_idx - 1);
+  }
+
+  /// sends to_left and to_right to the neighbours and returns what they sent here, one rank talks to itself
+  template <class Configuration, class RandomNumberGenerator>
+  inline void DomainDecomposition<Configuration, RandomNumberGenerator>::exchange(const std::vector<double>& to_left, const std::vector<double>& to_right, std::vector<double>& received, const int& tag)
+  {
+    received.clear();
+    if (num_ranks == 1)
+      return;
+
+    boost::mpi::request send_requests[2];
+    send_requests[0] = communicator.isend(left_rank, tag, to_left);
+    send_requests[1] = communicator.isend(right_rank, tag + 1, to_right);
+    std::vector<double> from_left, from_right;
+    communicator.recv(right_rank, tag, from_right);
+    communicator.recv(left_rank, tag + 1, from_left);
+    boost::mpi::wait_all(send_requests, send_requests + 2);
+
+    received.swap(from_left);
+    received.insert(received.end(), from_right.begin(), from_right.end());
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline void DomainDecomposition<Configuration, RandomNumberGenerator>::insert_discs(const std::vector<double>& coors)
+  {
+    for (std::size_t coor_idx = 0; coor_idx + dimensions_per_disc <= coors.size(); coor_idx += dimensions_per_disc)
+      configuration->insert_disc(Point(coors[coor_idx], coors[coor_idx + 1], coors[coor_idx + 2]));
+  }
+
+  /// hands the discs which are no longer in the slab of this rank to their new owner, expects the ghosts gone
+  /// The offset moves by less than a slab, so a disc only ever goes to a neighbour.
+  template <class Configuration, class RandomNumberGenerator>
+  inline void DomainDecomposition<Configuration, RandomNumberGenerator>::migrate()
+  {
+    std::vector<double> to_left, to_right, received;
+    for (disc_id_type disc_idx = configuration->get_number_of_discs(); disc_idx > 0; disc_idx--)
+      {
+	const Point center = configuration->get_disc_center(disc_idx - 1);
+	const int owner = get_owner(center);
+	if (owner == rank)
+	  continue;
+	std::vector<double>& outgoing = (owner == left_rank) ? to_left : to_right;
+	for (uint8_t axis = 0; axis < dimensions; axis++)
+	  outgoing.push_back(center.get_coor(axis));
+	configuration->remove_disc(disc_idx - 1);
+      }
+
+    exchange(to_left, to_right, received, migration_tag);
+    insert_discs(received);
+  }
+
+  /// replaces the ghosts by the discs of the neighbours up to halo_depth from the slab boundaries
+  template <class Configuration, class RandomNumberGenerator>
+  inline void DomainDecomposition<Configuration, RandomNumberGenerator>::exchange_halos()
+  {
+    remove_ghosts();
+
+    std::vector<double> to_left, to_right, received;
+    const double slab_lower = rank * slab_width;
+    for (disc_id_type disc_idx = 0; disc_idx < configuration->get_number_of_discs(); disc_idx++)
+      {
+	const Point center = configuration->get_disc_center(disc_idx);
+	const double slab_coor = get_slab_coor(center);
+	if (slab_coor - slab_lower < halo_depth)
+	  for (uint8_t axis = 0; axis < dimensions; axis++)
+	    to_left.push_back(center.get_coor(axis));
+	if (slab_lower + slab_width - slab_coor <= halo_depth)
+	  for (uint8_t axis = 0; axis < dimensions; axis++)
+	    to_right.push_back(center.get_coor(axis));
+      }
+
+    exchange(to_left, to_right, received, halo_tag);
+    insert_discs(received);
+  }
+
+  /// grand canonical steps in one half of the slab, returns the number of accepted steps
+  /// Weights are exp(-beta N) as in Mocasinns' do_metropolis_steps, so beta is minus beta mu.
+  template <class Configuration, class RandomNumberGenerator>
+  inline uint64_t DomainDecomposition<Configuration, RandomNumberGenerator>::sub_sweep(const double& beta, const uint32_t& half, const uint32_t& num_steps)
+  {
+    const double sphere_volume = M_PI * 4. / 3. * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS;
+    const double thermal_wavelength_pow_3 = sphere_volume;
+    const double half_width = slab_width / 2.;
+    const double half_lower = rank * slab_width + half * half_width;
+    const double half_volume = half_width * extents[1] * extents[2];
+    const double insertion_factor = exp(-beta) * half_volume / thermal_wavelength_pow_3;
+
+    disc_id_type num_active = 0;
+    for (disc_id_type disc_idx = 0; disc_idx < configuration->get_number_of_discs(); disc_idx++)
+      {
+	const double slab_coor = get_slab_coor(configuration->get_disc_center(disc_idx));
+	num_active += (slab_coor >= half_lower && slab_coor < half_lower + half_width) ? 1 : 0;
+      }
+
+    uint64_t accepted_steps = 0;
+    for (uint32_t step = 0; step < num_steps; step++)
+      {
+	const double step_type_random = step_rng.random_double();
+	if (step_type_random >= P_remove_threshold)
+	  {
+	    Point center(&step_rng, extents);
+	    double insert_coor = slab_offset + half_lower + step_rng.random_double() * half_width;
+	    center.set_coor(0, (insert_coor >= extents[0]) ? insert_coor - extents[0] : insert_coor);
+	    if (get_slab_coor(center) < half_lower || get_slab_coor(center) >= half_lower + half_width)
+	      continue; // rounding at the boundary of the half
+	    if (step_rng.random_double() >= insertion_factor / (num_active + 1) || configuration->is_overlapping(Disc(center, no_disc)))
+	      continue;
+	    configuration->insert_disc(center);
+	    // the stored center may be rounded out of the half, the disc would end up with two owners or none
+	    const double stored_slab_coor = get_slab_coor(configuration->get_disc_center(configuration->get_number_of_discs() - 1));
+	    if (stored_slab_coor < half_lower || stored_slab_coor >= half_lower + half_width)
+	      {
+		configuration->remove_disc(configuration->get_number_of_discs() - 1);
+		continue;
+	      }
+	    num_active++;
+	    accepted_steps++;
+	    continue;
+	  }
+
+	if (num_active == 0)
+	  continue;
+	// uniform among the discs of the half
+	disc_id_type disc_idx;
+	double slab_coor;
+	do
+	  {
+	    disc_idx = step_rng.random_uint32(0, configuration->get_number_of_discs() - 1);
+	    slab_coor = get_slab_coor(configuration->get_disc_center(disc_idx));
+	  }
+	while (slab_coor < half_lower || slab_coor >= half_lower + half_width);
+
+	if (step_type_random < P_move)
+	  {
+	    const Point displacement(&step_rng, max_move_size);
+	    Point displaced_center = configuration->get_disc_center(disc_idx) + displacement;
+	    displaced_center.rebase_periodic(extents);
+	    const double displaced_slab_coor = get_slab_coor(displaced_center);
+	    if (displaced_slab_coor < half_lower || displaced_slab_coor >= half_lower + half_width || configuration->is_overlapping_after_displacement(disc_idx, displacement))
+	      continue;
+	    configuration->move_disc(disc_idx, displacement);
+	    const double stored_slab_coor = get_slab_coor(configuration->get_disc_center(disc_idx));
+	    if (stored_slab_coor < half_lower || stored_slab_coor >= half_lower + half_width)
+	      {
+		configuration->move_disc(disc_idx, -displacement);
+		continue;
+	      }
+	    accepted_steps++;
+	  }
+	else if (step_rng.random_double() < num_active / insertion_factor)
+	  {
+	    configuration->remove_disc(disc_idx);
+	    num_active--;
+	    accepted_steps++;
+	  }
+      }
+
+    configuration->add_simulation_time(accepted_steps);
+    return accepted_steps;
+  }
+
+  /// num_steps grand canonical steps on every rank, half of them in each half of the slab, returns the accepted ones of this rank
+  /// Collective, all ranks have to call it with the same arguments.
+  template <class Configuration, class RandomNumberGenerator>
+  inline uint64_t DomainDecomposition<Configuration, RandomNumberGenerator>::sweep(const double& beta, const uint32_t& num_steps)
+  {
+    // the ghosts belong to the old slabs
+    remove_ghosts();
+    slab_offset = offset_rng.random_double() * slab_width;
+    migrate();
+
+    uint64_t accepted_steps = 0;
+    for (uint32_t half = 0; half < 2; half++)
+      {
+	exchange_halos();
+	accepted_steps += sub_sweep(beta, half, (num_steps + 1 - half) / 2);
+      }
+    return accepted_steps;
+  }
+
+  template <class Configuration, class RandomNumberGenerator>
+  inline disc_id_type DomainDecomposition<Configuration, RandomNumberGenerator>::get_number_of_owned_discs() const
+  {
+    disc_id_type num_owned = 0;
+    for (disc_id_type disc_idx = 0; disc_idx < configuration->get_number_of_discs(); disc_idx++)
+      num_owned += (get_owner(configuration->get_disc_center(disc_idx)) == rank) ? 1 : 0;
+    return num_owned;
+  }
+
+  /// number of discs in the whole box, collective
+  template <class Configuration, class RandomNumberGenerator>
+  inline disc_id_type DomainDecomposition<Configuration, RandomNumberGenerator>::get_number_of_discs() const
+  {
+    return boost::mpi::all_reduce(communicator, get_number_of_owned_discs(), std::plus<disc_id_type>());
+  }
+
+  /// all disc centers on rank 0, empty on the other ranks, collective
+  template <class Configuration, class RandomNumberGenerator>
+  inline std::vector<Point> DomainDecomposition<Configuration, RandomNumberGenerator>::gather_disc_centers() const
+  {
+    std::vector<double> owned_coors;
+    for (disc_id_type disc_idx = 0; disc_idx < configuration->get_number_of_discs(); disc_idx++)
+      {
+	const Point center = configuration->get_disc_center(disc_idx);
+	if (get_owner(center) != rank)
+	  continue;
+	for (uint8_t axis = 0; axis < dimensions; axis++)
+	  owned_coors.push_back(center.get_coor(axis));
+      }
+
+    std::vector<std::vector<double> > rank_coors;
+    boost::mpi::gather(communicator, owned_coors, rank_coors, 0);
+
+    std::vector<Point> centers;
+    for (std::size_t rank_idx = 0; rank_idx < rank_coors.size(); rank_idx++)
+      for (std::size_t coor_idx = 0; coor_idx + dimensions_per_disc <= rank_coors[rank_idx].size(); coor_idx += dimensions_per_disc)
+	centers.push_back(Point(rank_coors[rank_idx][coor_idx], rank_coors[rank_idx][coor_idx + 1], rank_coors[rank_idx][coor_idx + 2]));
+    return centers;
+  }
+
+}
+
+#endif
@@ -0,0 +1,105 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file DomainDecomposition.hpp
+ * \brief Grand canonical sweeps of hard discs split over MPI ranks -- header
+ *
+ * The box is cut into one slab along x per rank. Every rank keeps a
+ * HardDiscs of the whole box, which holds the discs of its slab and, as
+ * ghosts, copies of the discs of the neighbouring slabs up to halo_depth
+ * from its boundaries. A disc belongs to the rank whose slab its center is
+ * in, so owned discs and ghosts are told apart by position alone.
+ *
+ * A sweep draws a new offset of the slabs, the same on all ranks, and
+ * passes the discs whose slab changed to the neighbouring rank. Then each
+ * rank runs two sub sweeps, the first in the lower half of its slab, the
+ * second in the upper half, and the halos are exchanged before each of
+ * them. Moves, insertions and removals stay in the active half: a move
+ * leaving it is rejected, insertions are proposed in it, removals pick one
+ * of its discs. The acceptance takes the volume and number of discs of
+ * the half, so each sub sweep samples the grand canonical ensemble of its
+ * half with the rest of the box fixed.
+ *
+ * The active halves of two ranks are at least half a slab apart, which is
+ * at least halo_depth, more than a diameter. So a rank never needs the
+ * discs its neighbours are moving, and the ghosts of the inactive halves
+ * next to it are up to date.
+ *
+ * Every rank holds the lookup table of the whole box, the work is split,
+ * the memory is not.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef DOMAINDECOMPOSITION_HPP
+#define DOMAINDECOMPOSITION_HPP
+
+#include <vector>
+#include <exception>
+
+#include <boost/mpi/communicator.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <Step.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd
+{
+  /// two cells of the widest grid, at least one diameter
+  const double halo_depth = 2. * 2. * DEFAULT_DISC_RADIUS / sqrt(3.);
+
+  class bad_slabs_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "The box is too short in x for that many ranks, a slab has to be wider than two halo depths.";
+    }
+  };
+
+  template <class Configuration, class RandomNumberGenerator>
+  class DomainDecomposition
+  {
+  private:
+    boost::mpi::communicator communicator;
+    Configuration* configuration;
+    coordinate_type extents;
+    int rank;
+    int num_ranks;
+    int left_rank;
+    int right_rank;
+    double slab_width;
+    /// lower boundary of the slab of rank 0
+    double slab_offset;
+    /// same stream on all ranks, draws the offsets
+    RandomNumberGenerator offset_rng;
+    /// stream of this rank
+    RandomNumberGenerator step_rng;
+
+    double get_slab_coor(const Point&) const;
+    int get_owner(const Point&) const;
+    void remove_ghosts();
+    void exchange(const std::vector<double>&, const std::vector<double>&, std::vector<double>&, const int&);
+    void insert_discs(const std::vector<double>&);
+    void migrate();
+    void exchange_halos();
+    uint64_t sub_sweep(const double&, const uint32_t&, const uint32_t&);
+
+    DomainDecomposition(const DomainDecomposition&);
+    DomainDecomposition& operator=(const DomainDecomposition&);
+  public:
+    DomainDecomposition(const boost::mpi::communicator&, Configuration*, const uint32_t&);
+    ~DomainDecomposition();
+    const int& get_rank() const;
+    const int& get_num_ranks() const;
+    disc_id_type get_number_of_owned_discs() const;
+    disc_id_type get_number_of_discs() const;
+    std::vector<Point> gather_disc_centers() const;
+    uint64_t sweep(const double&, const uint32_t&);
+  };
+
+}
+
+#include <DomainDecomposition.cpp>
+
+#endif
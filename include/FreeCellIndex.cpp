@@ -0,0 +1,190 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file FreeCellIndex.cpp
+ * \brief Index of the cells which can take another disc -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef FREECELLINDEX_HPP
+
+#include <algorithm>
+
+#include <cassert>
+#include <cmath>
+
+namespace mcchd {
+
+  /// linear indices of the cells inside the exclusion sphere of a disc at center, returns their number
+  /// The farthest point of a cell along an axis is bounded by the periodic distance to the cell center
+  /// plus half the cell scale, so a cell is only taken if all its points surely overlap.
+  inline std::size_t FreeCellIndex::get_covered_cells(const Point& center, covered_cells_type& covered_cells) const
+  {
+    const double contact = 2 * DEFAULT_DISC_RADIUS;
+    const double contact_squared = contact * contact;
+
+    multi_index_type axis_count;
+    boost::array<boost::array<index_type, 5>, dimensions> axis_offsets;
+    boost::array<boost::array<double, 5>, dimensions> axis_far_squared;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const index_type& axis_cells = num_cells[axis];
+	const double coor = fmod(center.get_coor(axis), extents[axis]);
+	const index_type own_cell = std::min(static_cast<index_type> (floor(coor / cell_scale[axis])), axis_cells - 1);
+
+	// own cell and two to each side, or every cell of short axes
+	const index_type candidates = std::min(axis_cells, static_cast<index_type> (5));
+	axis_count[axis] = 0;
+	for (index_type candidate = 0; candidate < candidates; candidate++)
+	  {
+	    const index_type cell = axis_cells >= 5 ? (own_cell + axis_cells - 2 + candidate) % axis_cells : candidate;
+	    const double center_distance = fabs((cell + 0.5) * cell_scale[axis] - coor);
+	    const double far = std::min(center_distance, extents[axis] - center_distance) + 0.5 * cell_scale[axis];
+	    if (far < contact)
+	      {
+		axis_offsets[axis][axis_count[axis]] = cell * cell_strides[axis];
+		axis_far_squared[axis][axis_count[axis]] = far * far;
+		axis_count[axis]++;
+	      }
+	  }
+      }
+
+    std::size_t count = 0;
+    for (index_type i = 0; i < axis_count[0]; i++)
+      for (index_type j = 0; j < axis_count[1]; j++)
+	for (index_type k = 0; k < axis_count[2]; k++)
+	  if (axis_far_squared[0][i] + axis_far_squared[1][j] + axis_far_squared[2][k] < contact_squared)
+	    covered_cells[count++] = axis_offsets[0][i] + axis_offsets[1][j] + axis_offsets[2][k];
+
+    return count;
+  }
+
+  inline FreeCellIndex::FreeCellIndex() : total_cells(0), cell_volume(0.)
+  {
+    extents.fill(0.);
+    cell_scale.fill(0.);
+    num_cells.fill(0);
+    cell_strides.fill(0);
+  }
+
+  inline FreeCellIndex::FreeCellIndex(const coordinate_type& new_extents)
+  {
+    extents = new_extents;
+    const double base_scale = 2 * DEFAULT_DISC_RADIUS;
+    const double cell_width_max = base_scale / sqrt(dimensions);
+    num_cells[0] = static_cast<index_type> (ceil(new_extents[0] / cell_width_max));
+    num_cells[1] = static_cast<index_type> (ceil(new_extents[1] / cell_width_max));
+    num_cells[2] = static_cast<index_type> (ceil(new_extents[2] / cell_width_max));
+    cell_scale[0] = new_extents[0] / num_cells[0];
+    cell_scale[1] = new_extents[1] / num_cells[1];
+    cell_scale[2] = new_extents[2] / num_cells[2];
+    cell_volume = cell_scale[0] * cell_scale[1] * cell_scale[2];
+
+    cell_strides[2] = 1;
+    cell_strides[1] = num_cells[2];
+    cell_strides[0] = num_cells[1] * num_cells[2];
+    total_cells = num_cells[0] * num_cells[1] * num_cells[2];
+
+    // empty box: every cell is free
+    cover_counts.assign(total_cells, 0);
+    free_cells.resize(total_cells);
+    free_slots.resize(total_cells);
+    for (index_type cell = 0; cell < total_cells; cell++)
+      {
+	free_cells[cell] = cell;
+	free_slots[cell] = cell;
+      }
+  }
+
+  inline FreeCellIndex::~FreeCellIndex()
+  {
+  }
+
+  inline std::size_t FreeCellIndex::get_number_of_free_cells() const
+  {
+    return free_cells.size();
+  }
+
+  inline double FreeCellIndex::get_free_volume() const
+  {
+    return free_cells.size() * cell_volume;
+  }
+
+  /// free volume after removing the disc at center
+  inline double FreeCellIndex::get_free_volume_without(const Point& center) const
+  {
+    covered_cells_type covered_cells;
+    const std::size_t count = get_covered_cells(center, covered_cells);
+    std::size_t freed_cells = 0;
+    for (std::size_t entry = 0; entry < count; entry++)
+      if (cover_counts[covered_cells[entry]] == 1)
+	freed_cells++;
+
+    return (free_cells.size() + freed_cells) * cell_volume;
+  }
+
+  inline bool FreeCellIndex::is_free(const Point& point) const
+  {
+    index_type cell = 0;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const index_type axis_idx = static_cast<index_type> (floor(fmod(point.get_coor(axis), extents[axis]) / cell_scale[axis]));
+	cell += std::min(axis_idx, num_cells[axis] - 1) * cell_strides[axis];
+      }
+    return cover_counts[cell] == 0;
+  }
+
+  /// uniformly distributed point in the free cells, there has to be at least one
+  template <class RandomNumberGenerator>
+  inline Point FreeCellIndex::random_free_point(RandomNumberGenerator* rng) const
+  {
+    assert(free_cells.size() > 0);
+    const index_type cell = free_cells[rng->random_uint32(0, free_cells.size() - 1)]; // free_cells.size() - 1 is included
+    const index_type i_idx = cell / cell_strides[0];
+    const index_type j_idx = (cell % cell_strides[0]) / cell_strides[1];
+    const index_type k_idx = cell % cell_strides[1];
+    const double x = (i_idx + rng->random_double()) * cell_scale[0];
+    const double y = (j_idx + rng->random_double()) * cell_scale[1];
+    const double z = (k_idx + rng->random_double()) * cell_scale[2];
+
+    return Point(x, y, z);
+  }
+
+  inline void FreeCellIndex::insert_disc(const Point& center)
+  {
+    covered_cells_type covered_cells;
+    const std::size_t count = get_covered_cells(center, covered_cells);
+    for (std::size_t entry = 0; entry < count; entry++)
+      {
+	const index_type cell = covered_cells[entry];
+	if (cover_counts[cell]++ == 0)
+	  {
+	    // the last free cell takes the slot
+	    const index_type moved_cell = free_cells.back();
+	    free_cells[free_slots[cell]] = moved_cell;
+	    free_slots[moved_cell] = free_slots[cell];
+	    free_cells.pop_back();
+	  }
+      }
+  }
+
+  inline void FreeCellIndex::remove_disc(const Point& center)
+  {
+    covered_cells_type covered_cells;
+    const std::size_t count = get_covered_cells(center, covered_cells);
+    for (std::size_t entry = 0; entry < count; entry++)
+      {
+	const index_type cell = covered_cells[entry];
+	assert(cover_counts[cell] > 0);
+	if (--cover_counts[cell] == 0)
+	  {
+	    free_slots[cell] = free_cells.size();
+	    free_cells.push_back(cell);
+	  }
+      }
+  }
+
+}
+
+#endif
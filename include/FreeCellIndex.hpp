@@ -0,0 +1,79 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file FreeCellIndex.hpp
+ * \brief Index of the cells which can take another disc -- header
+ *
+ * Pure helper class for the cavity biased insertion of HardDiscs
+ *
+ * Same cell geometry as LookupTable_Flat. A cell is covered, if it lies
+ * completely inside the exclusion sphere (radius one diameter) of some
+ * disc, so no disc can be inserted anywhere in it. Every cell counts the
+ * discs covering it, the cells with a count of zero are kept in an
+ * unordered list for uniform sampling. Inserting, removing or moving a disc
+ * only touches the cells around it.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef FREECELLINDEX_HPP
+#define FREECELLINDEX_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/array.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  /// at most 5 cells per axis can be covered by one disc
+  const std::size_t max_covered_cells = 125;
+  typedef boost::array<index_type, max_covered_cells> covered_cells_type;
+
+  class FreeCellIndex
+  {
+  private:
+    coordinate_type extents;
+    coordinate_type cell_scale;
+    multi_index_type num_cells;
+    multi_index_type cell_strides; /// linear offset of one step along each axis
+    index_type total_cells;
+    double cell_volume;
+    std::vector<uint16_t> cover_counts; /// number of discs covering each cell
+    std::vector<index_type> free_cells; /// cells with a cover count of 0, unordered
+    std::vector<index_type> free_slots; /// cell -> position in free_cells, only valid for free cells
+
+    std::size_t get_covered_cells(const Point&, covered_cells_type&) const;
+  public:
+    FreeCellIndex();
+    FreeCellIndex(const coordinate_type&);
+    ~FreeCellIndex();
+    std::size_t get_number_of_free_cells() const;
+    double get_free_volume() const;
+    double get_free_volume_without(const Point&) const;
+    bool is_free(const Point&) const;
+    template <class RandomNumberGenerator> Point random_free_point(RandomNumberGenerator*) const;
+    void insert_disc(const Point&);
+    void remove_disc(const Point&);
+
+    /// the order of the free cells decides which cell random_free_point draws, so it is archived as is
+    /// The cell geometry is not archived, only load into an index of the same extents.
+    template<class Archive> void serialize(Archive & ar, const unsigned int)
+    {
+      ar & cover_counts;
+      ar & free_cells;
+      ar & free_slots;
+    }
+  };
+
+}
+
+#include <FreeCellIndex.cpp>
+
+#endif
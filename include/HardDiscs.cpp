@@ -13,17 +13,19 @@
 
 #ifdef HARDDISKS_HPP
 
+#include <algorithm>
+
 #include <cmath>
 
 namespace mcchd
 {
-  template<class CollisionFunctor, class LookupTable>
-  HardDiscs<CollisionFunctor, LookupTable>::HardDiscs() : simulation_time(0)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  HardDiscs<CollisionFunctor, LookupTable, Positions>::HardDiscs() : cavity_bias(false), transition_matrix(0), simulation_time(0)
   {
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  HardDiscs<CollisionFunctor, LookupTable>::HardDiscs(const coordinate_type& new_extents) : container(new_extents), disc_table(new_extents), simulation_time(0)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  HardDiscs<CollisionFunctor, LookupTable, Positions>::HardDiscs(const coordinate_type& new_extents) : container(new_extents), disc_table(new_extents), cavity_bias(false), transition_matrix(0), simulation_time(0)
   {
     extents = new_extents;
     volume = (extents[0] * extents[1] * extents[2]);
@@ -32,113 +34,178 @@ namespace mcchd
     const double max_occupied_volume = volume * close_packing_fraction;
     const double sphere_volume = M_PI * 4. / 3. * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS;
     const disc_id_type max_discs = static_cast<disc_id_type> (ceil(max_occupied_volume / sphere_volume));
-    for (disc_id_type disc_id = 0; disc_id < max_discs; disc_id++)
-      {
-	all_discs.push_back(new Disc(disc_id));
-      }
-
-    num_present = 0; /// initial configuration: no disc present at start
+    disc_positions = Positions(max_discs, extents); /// initial configuration: no disc present at start
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  HardDiscs<CollisionFunctor, LookupTable>::~HardDiscs()
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  HardDiscs<CollisionFunctor, LookupTable, Positions>::~HardDiscs()
   {
-    while(!all_discs.empty())
-      {
-	delete all_discs.back();
-	all_discs.pop_back();
-      }
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  coordinate_type HardDiscs<CollisionFunctor, LookupTable>::get_extents() const
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  coordinate_type HardDiscs<CollisionFunctor, LookupTable, Positions>::get_extents() const
   {
     return extents;
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  const disc_id_type& HardDiscs<CollisionFunctor, LookupTable>::get_number_of_discs() const
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  const disc_id_type& HardDiscs<CollisionFunctor, LookupTable, Positions>::get_number_of_discs() const
   {
-    return num_present;
+    return disc_positions.get_number_of_discs();
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  energy_type HardDiscs<CollisionFunctor, LookupTable>::energy() const
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  energy_type HardDiscs<CollisionFunctor, LookupTable, Positions>::energy() const
   {
-    return num_present;
+    return disc_positions.get_number_of_discs();
   }  
 
-  template<class CollisionFunctor, class LookupTable>
-  const time_type& HardDiscs<CollisionFunctor, LookupTable>::get_simulation_time() const
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  const time_type& HardDiscs<CollisionFunctor, LookupTable, Positions>::get_simulation_time() const
   {
     return simulation_time;
   }  
 
-  template<class CollisionFunctor, class LookupTable>
-  const double& HardDiscs<CollisionFunctor, LookupTable>::get_volume() const
+  /// for steps committed outside of commit(), e.g. by CheckerboardSweeps
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::add_simulation_time(const time_type& committed_steps)
+  {
+    simulation_time += committed_steps;
+  }
+
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  const double& HardDiscs<CollisionFunctor, LookupTable, Positions>::get_volume() const
   {
     return volume;
   }  
 
-  template<class CollisionFunctor, class LookupTable>
-  bool HardDiscs<CollisionFunctor, LookupTable>::is_overlapping_after_displacement(const disc_id_type& disc_idx, const Point& random_displacement)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  Point HardDiscs<CollisionFunctor, LookupTable, Positions>::get_disc_center(const disc_id_type& disc_idx) const
   {
-    Disc future_disc = Disc(*all_discs[disc_idx]);
-    Point future_position = future_disc.get_center() + random_displacement;
-    future_position.rebase_periodic(extents);
-    future_disc.translate_to(future_position);
-    
-    return is_overlapping(future_disc);
+    return disc_positions.get_center(disc_idx);
+  }
+
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  bool HardDiscs<CollisionFunctor, LookupTable, Positions>::is_overlapping_after_displacement(const disc_id_type& disc_idx, const Point& random_displacement) const
+  {
+    const typename Positions::stored_center_type displaced_center = disc_positions.get_displaced_stored_center(disc_idx, random_displacement);
+    return is_overlapping_at(Disc(disc_positions.to_point(displaced_center), disc_idx), displaced_center);
   }
   
-  template<class CollisionFunctor, class LookupTable>
-  bool HardDiscs<CollisionFunctor, LookupTable>::is_overlapping(const Disc& test_disc)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  bool HardDiscs<CollisionFunctor, LookupTable, Positions>::is_overlapping(const Disc& test_disc) const
   {
+    return is_overlapping_at(test_disc, disc_positions.to_stored_center(test_disc.get_center()));
+  }
+
+  /// the lookup table finds the cells from the stored center, the container and the neighbours check the test disc
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  bool HardDiscs<CollisionFunctor, LookupTable, Positions>::is_overlapping_at(const Disc& test_disc, const typename Positions::stored_center_type& stored_center) const
+  {
+    // a test disc outside the configuration landing in an occupied cell surely overlaps its resident
+    // A disc of the configuration may find itself in the cell, so it always takes the full check.
+    if (test_disc.get_id() == no_disc && disc_table.cell_occupied(stored_center))
+      return true;
+
     const bool collides_with_container = container.collides_with(test_disc);
     if (collides_with_container)
       return true;
 
-    bool collides_with_other_disc = false;
+    // stops at the first overlapping neighbour
+    return disc_table.any_overlap(stored_center, DiscOverlapPredicate<Positions>(disc_positions, test_disc, extents));
+  }
 
-    disc_table.get_neighbouring_discs(test_disc.get_center(), neighbouring_discs);
-    for (DiscVec::const_iterator neighbour_cit = neighbouring_discs.begin(); neighbour_cit != neighbouring_discs.end(); neighbour_cit++)
+  /// cavity biased insertion: insertions are only proposed in cells which can take a disc
+  /// Switching it on builds the index of free cells from the present discs.
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::set_cavity_bias(const bool& use_cavity_bias)
+  {
+    cavity_bias = use_cavity_bias;
+    free_cells = FreeCellIndex();
+    if (cavity_bias)
       {
-	if ((*(*neighbour_cit) != test_disc) && (*neighbour_cit)->is_overlapping(test_disc, extents))
-	  {
-	    collides_with_other_disc = true;
-	    break;
-	  }
+	free_cells = FreeCellIndex(extents);
+	for (disc_id_type disc_idx = 0; disc_idx < disc_positions.get_number_of_discs(); disc_idx++)
+	  free_cells.insert_disc(disc_positions.get_center(disc_idx));
       }
+  }
 
-    return collides_with_other_disc;
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  const bool& HardDiscs<CollisionFunctor, LookupTable, Positions>::get_cavity_bias() const
+  {
+    return cavity_bias;
   }
 
-  template <class CollisionFunctor, class LookupTable>
+  /// volume insertions are proposed in, the whole box or the free cells
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  double HardDiscs<CollisionFunctor, LookupTable, Positions>::get_insertion_volume() const
+  {
+    if (cavity_bias)
+      return free_cells.get_free_volume();
+    return volume;
+  }
+
+  /// volume insertions are proposed in after removing the disc, needed for the reverse of a removal
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  double HardDiscs<CollisionFunctor, LookupTable, Positions>::get_insertion_volume_without(const disc_id_type& disc_idx) const
+  {
+    if (cavity_bias && disc_idx < disc_positions.get_number_of_discs())
+      return free_cells.get_free_volume_without(disc_positions.get_center(disc_idx));
+    return get_insertion_volume();
+  }
+
+  /// the transition matrix collects the proposed steps, 0 switches collecting off
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::set_transition_matrix(TransitionMatrix* new_transition_matrix)
+  {
+    transition_matrix = new_transition_matrix;
+  }
+
+  /// infinite temperature acceptance of the step, the ratio of the proposal probabilities of its reverse and itself
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::record_proposed_step(const Step<HardDiscs<CollisionFunctor, LookupTable, Positions> >& proposed_step)
+  {
+    const double acceptance_probability = proposed_step.is_move_step() ? 1. : (proposed_step.is_executable() ? std::min(1., 1. / proposed_step.selection_probability_factor()) : 0.);
+    transition_matrix->record(disc_positions.get_number_of_discs(), proposed_step.delta_E(), acceptance_probability);
+  }
+
+  template <class CollisionFunctor, class LookupTable, class Positions>
   template <class RandomNumberGenerator>
-  Step<HardDiscs<CollisionFunctor, LookupTable> > HardDiscs<CollisionFunctor, LookupTable>::propose_step(RandomNumberGenerator* rng)
+  Step<HardDiscs<CollisionFunctor, LookupTable, Positions> > HardDiscs<CollisionFunctor, LookupTable, Positions>::propose_step(RandomNumberGenerator* rng)
   {
     const double step_type_random = rng->random_double();
+    const disc_id_type num_present = disc_positions.get_number_of_discs();
     if (step_type_random < P_move)
       {
 	const disc_id_type random_disc = rng->random_uint32(0, num_present > 0 ? num_present - 1 : 0); // num_present - 1 is included
 	Point random_displacement = Point(rng, max_move_size); // random point in sphere
 	// Point random_displacement = Point(rng, max_displacement_boundaries); // random point in box
-	return Step<HardDiscs<CollisionFunctor, LookupTable> >(this, random_disc, random_displacement); // move constructor
+	Step<HardDiscs<CollisionFunctor, LookupTable, Positions> > move_step(this, random_disc, random_displacement); // move constructor
+	if (transition_matrix)
+	  record_proposed_step(move_step);
+	return move_step;
       }
     else if (step_type_random < P_remove_threshold)
       {
 	const disc_id_type random_disc = rng->random_uint32(0, num_present > 0 ? num_present - 1 : 0); // num_present - 1 is included
-	return Step<HardDiscs<CollisionFunctor, LookupTable> >(this, random_disc); // remove constructor
+	Step<HardDiscs<CollisionFunctor, LookupTable, Positions> > remove_step(this, random_disc); // remove constructor
+	if (transition_matrix)
+	  record_proposed_step(remove_step);
+	return remove_step;
       }
     else
       {
-	Point random_center = Point(rng, extents);
-	return Step<HardDiscs<CollisionFunctor, LookupTable> >(this, random_center); /// insert constructor
+	// without free cells every insertion fails, the uniform proposal is as good as any
+	Point random_center = (cavity_bias && free_cells.get_number_of_free_cells() > 0) ? free_cells.random_free_point(rng) : Point(rng, extents);
+	Step<HardDiscs<CollisionFunctor, LookupTable, Positions> > insert_step(this, random_center); /// insert constructor
+	if (transition_matrix)
+	  record_proposed_step(insert_step);
+	return insert_step;
       }
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  void HardDiscs<CollisionFunctor, LookupTable>::commit(Step<HardDiscs<CollisionFunctor, LookupTable> >& step_to_commit)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::commit(Step<HardDiscs<CollisionFunctor, LookupTable, Positions> >& step_to_commit)
   {
     if (step_to_commit.is_move_step())
       {
@@ -155,39 +222,41 @@ namespace mcchd
     simulation_time += 1;
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  void HardDiscs<CollisionFunctor, LookupTable>::move_disc(const disc_id_type& disc_idx, const Point& random_displacement)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::move_disc(const disc_id_type& disc_idx, const Point& random_displacement)
   {
-    Disc* const to_be_moved = all_discs[disc_idx];
-    Point future_position = to_be_moved->get_center() + random_displacement;
-    future_position.rebase_periodic(extents);
-
-    disc_table.remove_disc(to_be_moved);
-    to_be_moved->translate_to(future_position);
-    disc_table.insert_disc(to_be_moved);
+    disc_table.remove_disc(disc_idx, disc_positions.get_stored_center(disc_idx));
+    if (cavity_bias)
+      free_cells.remove_disc(disc_positions.get_center(disc_idx));
+    disc_positions.set_stored_center(disc_idx, disc_positions.get_displaced_stored_center(disc_idx, random_displacement));
+    // the table gets the center as stored, which may be rounded
+    disc_table.insert_disc(disc_idx, disc_positions.get_stored_center(disc_idx));
+    if (cavity_bias)
+      free_cells.insert_disc(disc_positions.get_center(disc_idx));
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  void HardDiscs<CollisionFunctor, LookupTable>::remove_disc(const disc_id_type& disc_idx)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::remove_disc(const disc_id_type& disc_idx)
   {
-    Disc* const to_be_removed = all_discs[disc_idx];
-    Disc* const last_disc = all_discs[num_present-1];
- 
-    all_discs[disc_idx] = last_disc;
-    all_discs[num_present-1] = to_be_removed;
-    num_present -= 1;
+    const disc_id_type last_idx = disc_positions.get_number_of_discs() - 1;
 
-    disc_table.remove_disc(to_be_removed);
+    disc_table.remove_disc(disc_idx, disc_positions.get_stored_center(disc_idx));
+    if (cavity_bias)
+      free_cells.remove_disc(disc_positions.get_center(disc_idx));
+    // the last disc takes the place of the removed one
+    if (disc_idx != last_idx)
+      disc_table.renumber_disc(last_idx, disc_idx, disc_positions.get_stored_center(last_idx));
+    disc_positions.swap_remove(disc_idx);
   }
 
-  template<class CollisionFunctor, class LookupTable>
-  void HardDiscs<CollisionFunctor, LookupTable>::insert_disc(const Point& new_coors)
+  template<class CollisionFunctor, class LookupTable, class Positions>
+  void HardDiscs<CollisionFunctor, LookupTable, Positions>::insert_disc(const Point& new_coors)
   {
-    Disc* const first_unused_disc = all_discs[num_present];
-    first_unused_disc->translate_to(new_coors);
-    num_present += 1;
+    const disc_id_type new_idx = disc_positions.append(new_coors);
 
-    disc_table.insert_disc(first_unused_disc);
+    disc_table.insert_disc(new_idx, disc_positions.get_stored_center(new_idx));
+    if (cavity_bias)
+      free_cells.insert_disc(disc_positions.get_center(new_idx));
   }
 }
 
@@ -12,6 +12,8 @@
  *
  * Contains LookupTable for fast overlap checks.
  * Contains CollisionFunctor for overlap checks with boundary.
+ * Contains FreeCellIndex for cavity biased insertions, if switched on.
+ * Records every proposed step in a TransitionMatrix, if one is set.
  * 
  * \author Johannes Knauf
  */
@@ -21,35 +23,56 @@
 
 #include <cstdint>
 #include <vector>
+#include <exception>
 
 #include <Step.hpp>
 #include <Point.hpp>
 #include <Disc.hpp>
+#include <DiscPositions.hpp>
+#include <DiscPositions_FixedPoint.hpp>
 #include <LookupTable_Fast.hpp>
+#include <FreeCellIndex.hpp>
+#include <TransitionMatrix.hpp>
 
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/split_member.hpp>
 
 #include <mcchd_typedefs.hpp>
 
 
 namespace mcchd {
 
-  template<class CollisionFunctor, class LookupTable = LookupTable_Fast>
+  class extents_mismatch_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "The archived configuration has other extents than the one it is loaded into.";
+    }
+  };
+
+  /// Positions is DiscPositions (double coordinates) or DiscPositions_FixedPoint
+  /// With DiscPositions_FixedPoint the lookup table has to find cells from fixed point centers, as LookupTable_Fast and LookupTable_Flat do.
+  template<class CollisionFunctor, class LookupTable = LookupTable_Fast, class Positions = DiscPositions>
   class HardDiscs {
   private:
     CollisionFunctor container;
-    /// all_discs is divided in 2 halves: 
-    ///  1st half (til idx == num_present): Disc is in the system
-    ///  2nd half (including and above idx == num_present): Disc is out of the system
-    DiscCollection all_discs; 
-    disc_id_type num_present;
+    /// disc centers, the first get_number_of_discs() of them are in the system
+    Positions disc_positions;
     LookupTable disc_table;
-    DiscVec neighbouring_discs;
+    /// cells which can take another disc, only maintained with cavity_bias
+    FreeCellIndex free_cells;
+    bool cavity_bias;
+    /// collects the proposed steps, not owned, 0 if none
+    TransitionMatrix* transition_matrix;
     coordinate_type extents;
     double volume;
     time_type simulation_time;
 
+    void record_proposed_step(const Step<HardDiscs<CollisionFunctor, LookupTable, Positions> >&);
+    bool is_overlapping_at(const Disc&, const typename Positions::stored_center_type&) const;
+
   public:
     HardDiscs();
     HardDiscs(const coordinate_type& extents);
@@ -58,19 +81,59 @@ namespace mcchd {
     coordinate_type get_extents() const;
     energy_type energy() const;
     const time_type& get_simulation_time() const;
+    void add_simulation_time(const time_type&);
     const double& get_volume() const;
-    bool is_overlapping_after_displacement(const disc_id_type&, const Point&);
-    bool is_overlapping(const Disc&);
-    template <class RandomNumberGenerator> Step<HardDiscs<CollisionFunctor, LookupTable> > propose_step(RandomNumberGenerator*);
-    void commit(Step<HardDiscs<CollisionFunctor, LookupTable> >&);
+    Point get_disc_center(const disc_id_type&) const;
+    bool is_overlapping_after_displacement(const disc_id_type&, const Point&) const;
+    bool is_overlapping(const Disc&) const;
+    void set_cavity_bias(const bool&);
+    const bool& get_cavity_bias() const;
+    double get_insertion_volume() const;
+    double get_insertion_volume_without(const disc_id_type&) const;
+    void set_transition_matrix(TransitionMatrix*);
+    template <class RandomNumberGenerator> Step<HardDiscs<CollisionFunctor, LookupTable, Positions> > propose_step(RandomNumberGenerator*);
+    void commit(Step<HardDiscs<CollisionFunctor, LookupTable, Positions> >&);
     void move_disc(const disc_id_type&, const Point&);
     void remove_disc(const disc_id_type&);
     void insert_disc(const Point&);
 
-    template<class Archive> void serialize(Archive & ar, const unsigned int)
+    /// the container is not archived, so a configuration is only loaded into one of the same extents
+    template<class Archive> void save(Archive & ar, const unsigned int) const
     {
-      ar & num_present;
+      ar & boost::serialization::make_array(extents.data(), dimensions);
+      ar & simulation_time;
+      ar & cavity_bias;
+      ar & disc_positions;
+      if (cavity_bias)
+	ar & free_cells;
     }
+
+    /// the lookup table is filled anew from the loaded disc centers
+    template<class Archive> void load(Archive & ar, const unsigned int)
+    {
+      coordinate_type archived_extents;
+      ar & boost::serialization::make_array(archived_extents.data(), dimensions);
+      if (archived_extents != extents)
+	throw extents_mismatch_exception();
+      ar & simulation_time;
+      bool archived_cavity_bias;
+      ar & archived_cavity_bias;
+
+      for (disc_id_type disc_idx = 0; disc_idx < disc_positions.get_number_of_discs(); disc_idx++)
+	disc_table.remove_disc(disc_idx, disc_positions.get_stored_center(disc_idx));
+      ar & disc_positions;
+      for (disc_id_type disc_idx = 0; disc_idx < disc_positions.get_number_of_discs(); disc_idx++)
+	disc_table.insert_disc(disc_idx, disc_positions.get_stored_center(disc_idx));
+      set_cavity_bias(false);
+      if (archived_cavity_bias)
+	{
+	  cavity_bias = true;
+	  free_cells = FreeCellIndex(extents);
+	  ar & free_cells;
+	}
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
   };
 
 }
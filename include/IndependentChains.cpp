@@ -0,0 +1,118 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file IndependentChains.cpp
+ * \brief Independent Metropolis chains in one process -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef INDEPENDENTCHAINS_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+namespace mcchd
+{
+  inline RunningAverage::RunningAverage() : count(0), mean(0.), sum_squared_deviations(0.)
+  {
+  }
+
+  inline RunningAverage::~RunningAverage()
+  {
+  }
+
+  inline void RunningAverage::add(const double& value)
+  {
+    count++;
+    const double deviation = value - mean;
+    mean += deviation / count;
+    sum_squared_deviations += deviation * (value - mean);
+  }
+
+  /// afterwards this holds mean and variance of both series together (Chan et al.)
+  inline void RunningAverage::merge(const RunningAverage& other)
+  {
+    if (other.count == 0)
+      return;
+    const uint64_t merged_count = count + other.count;
+    const double deviation = other.mean - mean;
+    mean += deviation * other.count / merged_count;
+    sum_squared_deviations += other.sum_squared_deviations + deviation * deviation * count * other.count / merged_count;
+    count = merged_count;
+  }
+
+  inline const uint64_t& RunningAverage::get_count() const
+  {
+    return count;
+  }
+
+  inline const double& RunningAverage::get_mean() const
+  {
+    return mean;
+  }
+
+  /// sample variance, 0 for less than two values
+  inline double RunningAverage::get_variance() const
+  {
+    return (count > 1) ? sum_squared_deviations / (count - 1) : 0.;
+  }
+
+  /// body of a pool thread, takes the next task not started yet until none is left
+  /// The first exception thrown by a task is kept, the thread stops taking tasks then.
+  template <class Task>
+  inline void run_pool_tasks(Task& task, const uint32_t& num_tasks, std::atomic<uint32_t>& next_task, std::exception_ptr& first_exception, std::mutex& exception_mutex)
+  {
+    for (uint32_t task_idx = next_task++; task_idx < num_tasks; task_idx = next_task++)
+      {
+	try
+	  {
+	    task(task_idx);
+	  }
+	catch (...)
+	  {
+	    std::lock_guard<std::mutex> lock(exception_mutex);
+	    if (!first_exception)
+	      first_exception = std::current_exception();
+	    return;
+	  }
+      }
+  }
+
+  /// calls task(task_idx) for every task_idx below num_tasks on num_threads threads, 0 for one per core
+  /// Returns when all tasks are done, an exception thrown by a task is rethrown here.
+  template <class Task>
+  inline void run_on_thread_pool(Task& task, const uint32_t& num_tasks, const uint32_t& num_threads)
+  {
+    uint32_t pool_size = (num_threads > 0) ? num_threads : std::thread::hardware_concurrency();
+    if (pool_size == 0)
+      pool_size = 1;
+    if (pool_size > num_tasks)
+      pool_size = num_tasks;
+
+    std::atomic<uint32_t> next_task(0);
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+    std::vector<std::thread> pool_threads;
+    for (uint32_t thread_idx = 0; thread_idx < pool_size; thread_idx++)
+      pool_threads.push_back(std::thread(run_pool_tasks<Task>, std::ref(task), std::cref(num_tasks), std::ref(next_task), std::ref(first_exception), std::ref(exception_mutex)));
+    for (uint32_t thread_idx = 0; thread_idx < pool_size; thread_idx++)
+      pool_threads[thread_idx].join();
+
+    if (first_exception)
+      std::rethrow_exception(first_exception);
+  }
+
+  /// text output: chain index and value, separated by a tab
+  template <class ValueType>
+  inline std::ostream& operator<<(std::ostream& output_stream, const ChainMeasurement<ValueType>& measurement)
+  {
+    return output_stream << measurement.chain << '\t' << measurement.value;
+  }
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file IndependentChains.hpp
+ * \brief Independent Metropolis chains in one process -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * Several chains, each with its own configuration and simulation, run on a
+ * pool of threads. A thread takes the next chain not started yet and runs
+ * it to the end. Each chain is seeded with mix_seed of the seed of the run
+ * and the chain index.
+ *
+ * Measurements of all chains go to one file, tagged with the chain index.
+ * RunningAverage keeps mean and variance of each chain, merge() pools them.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef INDEPENDENTCHAINS_HPP
+#define INDEPENDENTCHAINS_HPP
+
+#include <ostream>
+#include <exception>
+
+#include <mcchd_typedefs.hpp>
+#include <SeedMixing.hpp>
+
+namespace mcchd
+{
+  /// one measurement of one chain, written as the raw struct by binary output
+  template <class ValueType>
+  struct ChainMeasurement
+  {
+    uint32_t chain;
+    ValueType value;
+  };
+
+  /// mean and variance of a series of values, updated value by value (Welford)
+  class RunningAverage
+  {
+  private:
+    uint64_t count;
+    double mean;
+    double sum_squared_deviations;
+  public:
+    RunningAverage();
+    ~RunningAverage();
+    void add(const double&);
+    void merge(const RunningAverage&);
+    const uint64_t& get_count() const;
+    const double& get_mean() const;
+    double get_variance() const;
+  };
+
+  template <class Task> void run_on_thread_pool(Task&, const uint32_t&, const uint32_t&);
+  template <class ValueType> std::ostream& operator<<(std::ostream&, const ChainMeasurement<ValueType>&);
+
+}
+
+#include <IndependentChains.cpp>
+
+#endif
@@ -34,8 +34,10 @@ namespace mcchd {
     const disc_id_type max_discs = static_cast<disc_id_type> (ceil(max_occupied_volume / sphere_volume));
     for (disc_id_type disc_id = 0; disc_id < max_discs; disc_id++)
       {
-	all_discs_mirror.push_back(NULL);
+	all_discs_mirror.push_back(empty_cell);
       }
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      all_coors_mirror[axis].resize(max_discs, 0.);
 
     num_present = 0; /// initial configuration: no disc present at start
   }
@@ -56,28 +58,67 @@ namespace mcchd {
     return neighbouring_discs;
   }
 
-  inline void LookupTable_Brute::remove_disc(Disc* const disc_to_be_removed)
+  /// the kernel finds the candidates, the predicate has the final word -- e.g. the test disc itself is skipped
+  template <class Predicate>
+  inline bool LookupTable_Brute::any_overlap(const Point& around_point, const Predicate& overlap_predicate) const
+  {
+    const double* xs = all_coors_mirror[0].data();
+    const double* ys = all_coors_mirror[1].data();
+    const double* zs = all_coors_mirror[2].data();
+
+    std::size_t first_unchecked = 0;
+    while (first_unchecked < num_present)
+      {
+	const std::size_t found = first_unchecked + find_overlap_batch(around_point, xs + first_unchecked, ys + first_unchecked, zs + first_unchecked, num_present - first_unchecked, extents);
+	if (found >= num_present)
+	  return false;
+	if (overlap_predicate(all_discs_mirror[found], Point(xs[found], ys[found], zs[found])))
+	  return true;
+	first_unchecked = found + 1;
+      }
+
+    return false;
+  }
+
+  /// always false, there are no cells to tell a sure overlap from
+  inline bool LookupTable_Brute::cell_occupied(const Point&) const
+  {
+    return false;
+  }
+
+  inline void LookupTable_Brute::remove_disc(const disc_id_type& disc_idx, const Point&)
   {
     for (disc_id_type disc_id = 0; disc_id < num_present; disc_id++)
       {
-	if (all_discs_mirror[disc_id] == disc_to_be_removed)
+	if (all_discs_mirror[disc_id] == disc_idx)
 	  {
-	    Disc* const to_be_removed = all_discs_mirror[disc_id];
-	    Disc* const last_disc = all_discs_mirror[num_present-1];
+	    const disc_id_type to_be_removed = all_discs_mirror[disc_id];
+	    const disc_id_type last_disc = all_discs_mirror[num_present-1];
 
 	    all_discs_mirror[disc_id] = last_disc;
 	    all_discs_mirror[num_present-1] = to_be_removed;
+	    for (uint8_t axis = 0; axis < dimensions; axis++)
+	      std::swap(all_coors_mirror[axis][disc_id], all_coors_mirror[axis][num_present-1]);
 	    num_present -= 1;
+	    break;
 	  }
       }
   }
 
-  inline void LookupTable_Brute::insert_disc(Disc* const disc_to_be_inserted)
+  inline void LookupTable_Brute::insert_disc(const disc_id_type& disc_idx, const Point& disc_center)
   {
-    all_discs_mirror[num_present] = disc_to_be_inserted;
+    all_discs_mirror[num_present] = disc_idx;
+    all_coors_mirror[0][num_present] = disc_center.get_coor(0);
+    all_coors_mirror[1][num_present] = disc_center.get_coor(1);
+    all_coors_mirror[2][num_present] = disc_center.get_coor(2);
     num_present += 1;
   }
 
+  inline void LookupTable_Brute::renumber_disc(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const Point&)
+  {
+    std::replace(all_discs_mirror.begin(), all_discs_mirror.begin() + num_present, old_disc_idx, new_disc_idx);
+  }
+
 }
 
 #endif
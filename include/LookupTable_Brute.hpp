@@ -6,6 +6,10 @@
  * 
  * Pure helper class for HardDiscs implementarion
  * 
+ * The disc centers are mirrored next to the disc indices, one contiguous
+ * array per axis, so any_overlap runs the SIMD kernel of OverlapKernel.hpp
+ * over all present discs.
+ * 
  * \author Johannes Knauf
  */
 
@@ -19,6 +23,7 @@
 
 #include <Point.hpp>
 #include <Disc.hpp>
+#include <OverlapKernel.hpp>
 #include <mcchd_typedefs.hpp>
 
 namespace mcchd {
@@ -27,7 +32,8 @@ namespace mcchd {
   {
   private:
     coordinate_type extents;
-    DiscCollection all_discs_mirror;
+    DiscVec all_discs_mirror;
+    boost::array<std::vector<double>, dimensions> all_coors_mirror; /// same order as all_discs_mirror
     disc_id_type num_present;
 
   public:
@@ -35,8 +41,11 @@ namespace mcchd {
     LookupTable_Brute(const coordinate_type&);
     ~LookupTable_Brute();
     DiscVec get_neighbouring_discs(const Point&) const;
-    void remove_disc(Disc* const);
-    void insert_disc(Disc* const);
+    template <class Predicate> bool any_overlap(const Point&, const Predicate&) const;
+    bool cell_occupied(const Point&) const;
+    void remove_disc(const disc_id_type&, const Point&);
+    void insert_disc(const disc_id_type&, const Point&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const Point&);
   };
 
 }
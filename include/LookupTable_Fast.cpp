@@ -26,6 +26,45 @@ namespace mcchd {
     return point_idx;
   }
 
+  /// additionally returns the position of the point inside its cell in units of the cell scale
+  inline multi_index_type LookupTable_Fast::get_cell_idx(const Point& point, coordinate_type& cell_fractions) const
+  {
+    multi_index_type point_idx;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const double scaled_coor = fmod(point.get_coor(axis), extents[axis]) / cell_scale[axis];
+	point_idx[axis] = static_cast<index_type> (floor(scaled_coor));
+	cell_fractions[axis] = scaled_coor - point_idx[axis];
+      }
+
+    return point_idx;
+  }
+
+  /// cells of fixed point coordinates, which are fractions of the extent in units of 2^-32
+  inline multi_index_type LookupTable_Fast::get_cell_idx(const fixed_coordinate_type& fixed_center) const
+  {
+    multi_index_type point_idx;
+    point_idx[0] = static_cast<index_type> ((static_cast<uint64_t> (fixed_center[0]) * num_cells[0]) >> 32);
+    point_idx[1] = static_cast<index_type> ((static_cast<uint64_t> (fixed_center[1]) * num_cells[1]) >> 32);
+    point_idx[2] = static_cast<index_type> ((static_cast<uint64_t> (fixed_center[2]) * num_cells[2]) >> 32);
+
+    return point_idx;
+  }
+
+  /// additionally returns the position inside the cell, the low bits of the product
+  inline multi_index_type LookupTable_Fast::get_cell_idx(const fixed_coordinate_type& fixed_center, coordinate_type& cell_fractions) const
+  {
+    multi_index_type point_idx;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const uint64_t scaled_coor = static_cast<uint64_t> (fixed_center[axis]) * num_cells[axis];
+	point_idx[axis] = static_cast<index_type> (scaled_coor >> 32);
+	cell_fractions[axis] = static_cast<uint32_t> (scaled_coor) * fixed_step_fraction;
+      }
+
+    return point_idx;
+  }
+
   inline LookupTable_Fast::LookupTable_Fast()
   {
   }
@@ -41,6 +80,7 @@ namespace mcchd {
     cell_scale[0] = new_extents[0] / num_cells[0];
     cell_scale[1] = new_extents[1] / num_cells[1];
     cell_scale[2] = new_extents[2] / num_cells[2];
+    neighbour_stencil = NeighbourStencil(cell_scale, num_cells);
 
     space_cells = new Cells3D(boost::extents[num_cells[0]][num_cells[1]][num_cells[2]]);
     for (index_type i = 0; i < num_cells[0]; i++)
@@ -49,7 +89,7 @@ namespace mcchd {
 	  {
 	    for (index_type k = 0; k < num_cells[2]; k++)
 	      {
-		((*space_cells)[i][j][k]) = NULL;
+		((*space_cells)[i][j][k]) = empty_cell;
 	      }
 	  }
       }
@@ -69,72 +109,122 @@ namespace mcchd {
   inline void LookupTable_Fast::get_neighbouring_discs(const Point& around_point, DiscVec& neighbouring_discs) const
   {
     neighbouring_discs.clear();
-    
-    multi_index_type multi_idx = get_cell_idx(around_point);
-    // using -2:2 is fuddled, for x_max < 4 it should be -3:3 to avoid collisions
-    // make check at initializtion? change correspondingly?
-    const int cell_range = 2;
-    const int max_cells = 2 * cell_range + 1;
-    boost::array<index_type, max_cells> i_idces, j_idces, k_idces;
-    
-    int cell = 0;
-    for (int i = -cell_range; i <= cell_range; i++)
-      {
-	const index_type pre_i_idx = (multi_idx[0] + i);
-	const index_type i_idx = pre_i_idx < 0 ? pre_i_idx + num_cells[0] : pre_i_idx >= num_cells[0] ? pre_i_idx - num_cells[0] : pre_i_idx;
-	i_idces[cell] = i_idx;
-	cell++;
-      }
+    any_overlap(around_point, NeighbourCollector(neighbouring_discs));
+  }
 
-    cell = 0;
-    for (int j = -cell_range; j <= cell_range; j++)
-      {
-	const index_type pre_j_idx = (multi_idx[1] + j);
-	const index_type j_idx = pre_j_idx < 0 ? pre_j_idx + num_cells[1] : pre_j_idx >= num_cells[1] ? pre_j_idx - num_cells[1] : pre_j_idx;
-	j_idces[cell] = j_idx;
-	cell++;
-      }
+  /// visits the discs around the point nearest cell first, stops at the first disc the predicate holds for
+  template <class Predicate>
+  inline bool LookupTable_Fast::any_overlap(const Point& around_point, const Predicate& overlap_predicate) const
+  {
+    coordinate_type cell_fractions;
+    const multi_index_type multi_idx = get_cell_idx(around_point, cell_fractions);
+    return any_overlap_around(multi_idx, cell_fractions, overlap_predicate);
+  }
 
-    cell = 0;
-    for (int k = -cell_range; k <= cell_range; k++)
-      {
-	const index_type pre_k_idx = (multi_idx[2] + k);
-	const index_type k_idx = pre_k_idx < 0 ? pre_k_idx + num_cells[2] : pre_k_idx >= num_cells[2] ? pre_k_idx - num_cells[2] : pre_k_idx;
-	k_idces[cell] = k_idx;
-	cell++;
-      }
+  template <class Predicate>
+  inline bool LookupTable_Fast::any_overlap(const fixed_coordinate_type& around_center, const Predicate& overlap_predicate) const
+  {
+    coordinate_type cell_fractions;
+    const multi_index_type multi_idx = get_cell_idx(around_center, cell_fractions);
+    return any_overlap_around(multi_idx, cell_fractions, overlap_predicate);
+  }
 
-    for (int i = 0; i < max_cells; i++)
+  /// the query of any_overlap, for the point at cell_fractions inside the cell multi_idx
+  template <class Predicate>
+  inline bool LookupTable_Fast::any_overlap_around(const multi_index_type& multi_idx, const coordinate_type& cell_fractions, const Predicate& overlap_predicate) const
+  {
+    const Cells3D::index* const strides = space_cells->strides();
+    const disc_id_type* const cells = space_cells->data();
+
+    stencil_axis_type i_offsets, j_offsets, k_offsets;
+    neighbour_stencil.get_axis_offsets(0, multi_idx[0], num_cells[0], strides[0], i_offsets);
+    neighbour_stencil.get_axis_offsets(1, multi_idx[1], num_cells[1], strides[1], j_offsets);
+    neighbour_stencil.get_axis_offsets(2, multi_idx[2], num_cells[2], strides[2], k_offsets);
+
+    // only cells which can hold an overlapping disc, nearest first
+    const stencil_type& stencil = neighbour_stencil.get_stencil(cell_fractions);
+    const std::size_t stencil_size = stencil.size();
+    for (std::size_t entry = 0; entry < stencil_size; entry++)
       {
-	const index_type i_idx = i_idces[i];
-	for (int j = 0; j < max_cells; j++)
+	if (entry + stencil_prefetch_distance < stencil_size)
 	  {
-	    const index_type j_idx = j_idces[j];
-	    for (int k = 0; k < max_cells; k++)
-	      {
-		const index_type k_idx = k_idces[k];
-
-		const Disc* found_disc = ((*space_cells)[i_idx][j_idx][k_idx]);
-		
- 		if (found_disc != NULL)
-		  neighbouring_discs.push_back(found_disc);
-	      }	    
+	    const stencil_entry_type& ahead = stencil[entry + stencil_prefetch_distance];
+	    __builtin_prefetch(cells + i_offsets[ahead[0]] + j_offsets[ahead[1]] + k_offsets[ahead[2]]);
 	  }
+
+	const stencil_entry_type& cell = stencil[entry];
+	const disc_id_type found_disc = cells[i_offsets[cell[0]] + j_offsets[cell[1]] + k_offsets[cell[2]]];
+
+	if (found_disc != empty_cell && overlap_predicate(found_disc))
+	  return true;
       }
+
+    return false;
+  }
+
+  /// a disc in the cell of the point surely overlaps a disc centered at the point, the cell diagonal is one diameter
+  inline bool LookupTable_Fast::cell_occupied(const Point& point) const
+  {
+    return cell_occupied_at(get_cell_idx(point));
+  }
+
+  inline bool LookupTable_Fast::cell_occupied(const fixed_coordinate_type& fixed_center) const
+  {
+    return cell_occupied_at(get_cell_idx(fixed_center));
+  }
+
+  inline void LookupTable_Fast::remove_disc(const disc_id_type& disc_idx, const Point& disc_center)
+  {
+    remove_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Fast::remove_disc(const disc_id_type& disc_idx, const fixed_coordinate_type& disc_center)
+  {
+    remove_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Fast::insert_disc(const disc_id_type& disc_idx, const Point& disc_center)
+  {
+    insert_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Fast::insert_disc(const disc_id_type& disc_idx, const fixed_coordinate_type& disc_center)
+  {
+    insert_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  /// the disc at disc_center changed its index, e.g. after swapping it into the place of a removed disc
+  inline void LookupTable_Fast::renumber_disc(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const Point& disc_center)
+  {
+    renumber_disc_at(old_disc_idx, new_disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Fast::renumber_disc(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const fixed_coordinate_type& disc_center)
+  {
+    renumber_disc_at(old_disc_idx, new_disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline bool LookupTable_Fast::cell_occupied_at(const multi_index_type& cell_idx) const
+  {
+    return (*space_cells)(cell_idx) != empty_cell;
+  }
+
+  inline void LookupTable_Fast::remove_disc_at(const disc_id_type& disc_idx, const multi_index_type& cell_idx)
+  {
+    assert((*space_cells)(cell_idx) == disc_idx);
+    (*space_cells)(cell_idx) = empty_cell;
   }
 
-  inline void LookupTable_Fast::remove_disc(Disc* const disc_to_be_removed)
+  inline void LookupTable_Fast::insert_disc_at(const disc_id_type& disc_idx, const multi_index_type& cell_idx)
   {
-    const multi_index_type cell_idx = get_cell_idx(disc_to_be_removed->get_center());
-    assert((*space_cells)(cell_idx) == disc_to_be_removed);
-    (*space_cells)(cell_idx) = NULL;
+    assert((*space_cells)(cell_idx) == empty_cell);
+    (*space_cells)(cell_idx) = disc_idx;
   }
 
-  inline void LookupTable_Fast::insert_disc(Disc* const disc_to_be_inserted)
+  inline void LookupTable_Fast::renumber_disc_at(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const multi_index_type& cell_idx)
   {
-    const multi_index_type cell_idx = get_cell_idx(disc_to_be_inserted->get_center());
-    assert((*space_cells)(cell_idx) == NULL);
-    (*space_cells)(cell_idx) = disc_to_be_inserted;
+    assert((*space_cells)(cell_idx) == old_disc_idx);
+    (*space_cells)(cell_idx) = new_disc_idx;
   }
 
 }
@@ -6,6 +6,10 @@
  * 
  * Pure helper class for HardDiscs implementarion
  * 
+ * Discs are found by their center, either as a Point or as the fixed point
+ * coordinates of DiscPositions_FixedPoint, whose cells are the top bits of
+ * the coordinate times the number of cells -- no fmod and no floor.
+ * 
  * \author Johannes Knauf
  */
 
@@ -19,6 +23,7 @@
 
 #include <Point.hpp>
 #include <Disc.hpp>
+#include <NeighbourStencil.hpp>
 #include <mcchd_typedefs.hpp>
 
 namespace mcchd {
@@ -30,16 +35,33 @@ namespace mcchd {
     coordinate_type cell_scale;
     multi_index_type num_cells;
     Cells3D* space_cells;
+    NeighbourStencil neighbour_stencil;
 
     multi_index_type get_cell_idx(const Point&) const;
+    multi_index_type get_cell_idx(const Point&, coordinate_type&) const;
+    multi_index_type get_cell_idx(const fixed_coordinate_type&) const;
+    multi_index_type get_cell_idx(const fixed_coordinate_type&, coordinate_type&) const;
+    template <class Predicate> bool any_overlap_around(const multi_index_type&, const coordinate_type&, const Predicate&) const;
+    bool cell_occupied_at(const multi_index_type&) const;
+    void remove_disc_at(const disc_id_type&, const multi_index_type&);
+    void insert_disc_at(const disc_id_type&, const multi_index_type&);
+    void renumber_disc_at(const disc_id_type&, const disc_id_type&, const multi_index_type&);
   public:
     LookupTable_Fast();
     LookupTable_Fast(const coordinate_type&);
     ~LookupTable_Fast();
     DiscVec get_neighbouring_discs(const Point&) const;
     void get_neighbouring_discs(const Point&, DiscVec&) const;
-    void remove_disc(Disc* const);
-    void insert_disc(Disc* const);
+    template <class Predicate> bool any_overlap(const Point&, const Predicate&) const;
+    template <class Predicate> bool any_overlap(const fixed_coordinate_type&, const Predicate&) const;
+    bool cell_occupied(const Point&) const;
+    bool cell_occupied(const fixed_coordinate_type&) const;
+    void remove_disc(const disc_id_type&, const Point&);
+    void remove_disc(const disc_id_type&, const fixed_coordinate_type&);
+    void insert_disc(const disc_id_type&, const Point&);
+    void insert_disc(const disc_id_type&, const fixed_coordinate_type&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const Point&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const fixed_coordinate_type&);
   };
 
 }
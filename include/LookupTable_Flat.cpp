@@ -0,0 +1,212 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file LookupTable_Flat.cpp
+ * \brief Lookup Table for Discs in periodic space -- flat index grid implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef LOOKUPTABLE_FLAT_HPP
+
+#include <algorithm>
+#include <new>
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+
+namespace mcchd {
+
+  inline index_type LookupTable_Flat::get_cell_idx(const Point& point) const
+  {
+    const index_type i_idx = static_cast<index_type> (floor(fmod(point.get_coor(0), extents[0]) / cell_scale[0]));
+    const index_type j_idx = static_cast<index_type> (floor(fmod(point.get_coor(1), extents[1]) / cell_scale[1]));
+    const index_type k_idx = static_cast<index_type> (floor(fmod(point.get_coor(2), extents[2]) / cell_scale[2]));
+
+    return i_idx * cell_strides[0] + j_idx * cell_strides[1] + k_idx * cell_strides[2];
+  }
+
+  /// cell of fixed point coordinates, the top bits of coordinate times number of cells
+  inline index_type LookupTable_Flat::get_cell_idx(const fixed_coordinate_type& fixed_center) const
+  {
+    const index_type i_idx = static_cast<index_type> ((static_cast<uint64_t> (fixed_center[0]) * num_cells[0]) >> 32);
+    const index_type j_idx = static_cast<index_type> ((static_cast<uint64_t> (fixed_center[1]) * num_cells[1]) >> 32);
+    const index_type k_idx = static_cast<index_type> ((static_cast<uint64_t> (fixed_center[2]) * num_cells[2]) >> 32);
+
+    return i_idx * cell_strides[0] + j_idx * cell_strides[1] + k_idx * cell_strides[2];
+  }
+
+  inline LookupTable_Flat::LookupTable_Flat() : total_cells(0), space_cells(NULL)
+  {
+  }
+
+  inline LookupTable_Flat::LookupTable_Flat(const coordinate_type& new_extents)
+  {
+    extents = new_extents;
+    const double base_scale = 2 * DEFAULT_DISC_RADIUS;
+    const double cell_width_max = base_scale / sqrt(dimensions); // guarantees only 1 disc per box
+    num_cells[0] = static_cast<index_type> (ceil(new_extents[0] / cell_width_max));
+    num_cells[1] = static_cast<index_type> (ceil(new_extents[1] / cell_width_max));
+    num_cells[2] = static_cast<index_type> (ceil(new_extents[2] / cell_width_max));
+    cell_scale[0] = new_extents[0] / num_cells[0];
+    cell_scale[1] = new_extents[1] / num_cells[1];
+    cell_scale[2] = new_extents[2] / num_cells[2];
+
+    // row major, same ordering as the multi_array in LookupTable_Fast
+    cell_strides[2] = 1;
+    cell_strides[1] = num_cells[2];
+    cell_strides[0] = num_cells[1] * num_cells[2];
+    total_cells = num_cells[0] * num_cells[1] * num_cells[2];
+    neighbour_stencil = NeighbourStencil(cell_scale, num_cells);
+
+    void* cell_memory = NULL;
+    if (posix_memalign(&cell_memory, cache_line_size, total_cells * sizeof(disc_id_type)) != 0)
+      throw std::bad_alloc();
+    space_cells = static_cast<disc_id_type*> (cell_memory);
+    std::fill(space_cells, space_cells + total_cells, empty_cell);
+  }
+
+  inline LookupTable_Flat::~LookupTable_Flat()
+  {
+    free(space_cells);
+  }
+
+  inline DiscVec LookupTable_Flat::get_neighbouring_discs(const Point& around_point) const
+  {
+    DiscVec neighbouring_discs;
+    get_neighbouring_discs(around_point, neighbouring_discs);
+    return neighbouring_discs;
+  }
+
+  inline void LookupTable_Flat::get_neighbouring_discs(const Point& around_point, DiscVec& neighbouring_discs) const
+  {
+    neighbouring_discs.clear();
+    any_overlap(around_point, NeighbourCollector(neighbouring_discs));
+  }
+
+  /// visits the discs around the point nearest cell first, stops at the first disc the predicate holds for
+  template <class Predicate>
+  inline bool LookupTable_Flat::any_overlap(const Point& around_point, const Predicate& overlap_predicate) const
+  {
+    multi_index_type center_idx;
+    coordinate_type cell_fractions;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const double scaled_coor = fmod(around_point.get_coor(axis), extents[axis]) / cell_scale[axis];
+	center_idx[axis] = static_cast<index_type> (floor(scaled_coor));
+	cell_fractions[axis] = scaled_coor - center_idx[axis];
+      }
+    return any_overlap_around(center_idx, cell_fractions, overlap_predicate);
+  }
+
+  /// the cell and the position inside it are the top and the low bits of coordinate times number of cells
+  template <class Predicate>
+  inline bool LookupTable_Flat::any_overlap(const fixed_coordinate_type& around_center, const Predicate& overlap_predicate) const
+  {
+    multi_index_type center_idx;
+    coordinate_type cell_fractions;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const uint64_t scaled_coor = static_cast<uint64_t> (around_center[axis]) * num_cells[axis];
+	center_idx[axis] = static_cast<index_type> (scaled_coor >> 32);
+	cell_fractions[axis] = static_cast<uint32_t> (scaled_coor) * fixed_step_fraction;
+      }
+    return any_overlap_around(center_idx, cell_fractions, overlap_predicate);
+  }
+
+  /// the query of any_overlap, for the point at cell_fractions inside the cell center_idx
+  template <class Predicate>
+  inline bool LookupTable_Flat::any_overlap_around(const multi_index_type& center_idx, const coordinate_type& cell_fractions, const Predicate& overlap_predicate) const
+  {
+    // periodically wrapped linear offsets along each axis
+    stencil_axis_type i_offsets, j_offsets, k_offsets;
+    neighbour_stencil.get_axis_offsets(0, center_idx[0], num_cells[0], cell_strides[0], i_offsets);
+    neighbour_stencil.get_axis_offsets(1, center_idx[1], num_cells[1], cell_strides[1], j_offsets);
+    neighbour_stencil.get_axis_offsets(2, center_idx[2], num_cells[2], cell_strides[2], k_offsets);
+
+    // only cells which can hold an overlapping disc, nearest first
+    const stencil_type& stencil = neighbour_stencil.get_stencil(cell_fractions);
+    const std::size_t stencil_size = stencil.size();
+    for (std::size_t entry = 0; entry < stencil_size; entry++)
+      {
+	if (entry + stencil_prefetch_distance < stencil_size)
+	  {
+	    const stencil_entry_type& ahead = stencil[entry + stencil_prefetch_distance];
+	    __builtin_prefetch(space_cells + i_offsets[ahead[0]] + j_offsets[ahead[1]] + k_offsets[ahead[2]]);
+	  }
+
+	const stencil_entry_type& cell = stencil[entry];
+	const disc_id_type found_id = space_cells[i_offsets[cell[0]] + j_offsets[cell[1]] + k_offsets[cell[2]]];
+
+	if (found_id != empty_cell && overlap_predicate(found_id))
+	  return true;
+      }
+
+    return false;
+  }
+
+  /// a disc in the cell of the point surely overlaps a disc centered at the point, the cell diagonal is one diameter
+  inline bool LookupTable_Flat::cell_occupied(const Point& point) const
+  {
+    return space_cells[get_cell_idx(point)] != empty_cell;
+  }
+
+  inline bool LookupTable_Flat::cell_occupied(const fixed_coordinate_type& fixed_center) const
+  {
+    return space_cells[get_cell_idx(fixed_center)] != empty_cell;
+  }
+
+  inline void LookupTable_Flat::remove_disc(const disc_id_type& disc_idx, const Point& disc_center)
+  {
+    remove_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Flat::remove_disc(const disc_id_type& disc_idx, const fixed_coordinate_type& disc_center)
+  {
+    remove_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Flat::insert_disc(const disc_id_type& disc_idx, const Point& disc_center)
+  {
+    insert_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Flat::insert_disc(const disc_id_type& disc_idx, const fixed_coordinate_type& disc_center)
+  {
+    insert_disc_at(disc_idx, get_cell_idx(disc_center));
+  }
+
+  /// the disc at disc_center changed its index, e.g. after swapping it into the place of a removed disc
+  inline void LookupTable_Flat::renumber_disc(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const Point& disc_center)
+  {
+    renumber_disc_at(old_disc_idx, new_disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Flat::renumber_disc(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const fixed_coordinate_type& disc_center)
+  {
+    renumber_disc_at(old_disc_idx, new_disc_idx, get_cell_idx(disc_center));
+  }
+
+  inline void LookupTable_Flat::remove_disc_at(const disc_id_type& disc_idx, const index_type& cell_idx)
+  {
+    assert(space_cells[cell_idx] == disc_idx);
+    space_cells[cell_idx] = empty_cell;
+  }
+
+  inline void LookupTable_Flat::insert_disc_at(const disc_id_type& disc_idx, const index_type& cell_idx)
+  {
+    assert(space_cells[cell_idx] == empty_cell);
+    assert(disc_idx != empty_cell);
+    space_cells[cell_idx] = disc_idx;
+  }
+
+  inline void LookupTable_Flat::renumber_disc_at(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const index_type& cell_idx)
+  {
+    assert(space_cells[cell_idx] == old_disc_idx);
+    space_cells[cell_idx] = new_disc_idx;
+  }
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file LookupTable_Flat.hpp
+ * \brief Lookup table header -- flat index grid version
+ *
+ * Pure helper class for HardDiscs implementarion
+ *
+ * Same cell geometry as LookupTable_Fast, but the cells live in one
+ * contiguous, cache line aligned array with precomputed linear strides
+ * instead of a multi_array. Fixed point centers find their cell from the
+ * top bits, as in LookupTable_Fast.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef LOOKUPTABLE_FLAT_HPP
+#define LOOKUPTABLE_FLAT_HPP
+
+#include <vector>
+
+#include <boost/array.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <NeighbourStencil.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  class LookupTable_Flat
+  {
+  private:
+    coordinate_type extents;
+    coordinate_type cell_scale;
+    multi_index_type num_cells;
+    multi_index_type cell_strides; /// linear offset of one step along each axis
+    index_type total_cells;
+    disc_id_type* space_cells; /// total_cells entries, aligned to cache_line_size
+    NeighbourStencil neighbour_stencil;
+
+    index_type get_cell_idx(const Point&) const;
+    index_type get_cell_idx(const fixed_coordinate_type&) const;
+    template <class Predicate> bool any_overlap_around(const multi_index_type&, const coordinate_type&, const Predicate&) const;
+    void remove_disc_at(const disc_id_type&, const index_type&);
+    void insert_disc_at(const disc_id_type&, const index_type&);
+    void renumber_disc_at(const disc_id_type&, const disc_id_type&, const index_type&);
+
+    // cells are owned by the table, no copies
+    LookupTable_Flat(const LookupTable_Flat&);
+    LookupTable_Flat& operator=(const LookupTable_Flat&);
+  public:
+    LookupTable_Flat();
+    LookupTable_Flat(const coordinate_type&);
+    ~LookupTable_Flat();
+    DiscVec get_neighbouring_discs(const Point&) const;
+    void get_neighbouring_discs(const Point&, DiscVec&) const;
+    template <class Predicate> bool any_overlap(const Point&, const Predicate&) const;
+    template <class Predicate> bool any_overlap(const fixed_coordinate_type&, const Predicate&) const;
+    bool cell_occupied(const Point&) const;
+    bool cell_occupied(const fixed_coordinate_type&) const;
+    void remove_disc(const disc_id_type&, const Point&);
+    void remove_disc(const disc_id_type&, const fixed_coordinate_type&);
+    void insert_disc(const disc_id_type&, const Point&);
+    void insert_disc(const disc_id_type&, const fixed_coordinate_type&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const Point&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const fixed_coordinate_type&);
+  };
+
+}
+
+#include <LookupTable_Flat.cpp>
+
+#endif
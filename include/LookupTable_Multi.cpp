@@ -0,0 +1,167 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file LookupTable_Multi.cpp
+ * \brief Lookup Table for Discs in periodic space -- multi occupancy cell implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef LOOKUPTABLE_MULTI_HPP
+
+#include <algorithm>
+
+#include <cassert>
+#include <cmath>
+
+namespace mcchd {
+
+  /// cell index of point along axis -- coordinates rounding up to the extent end up in the last cell
+  inline index_type LookupTable_Multi::get_axis_idx(const uint8_t& axis, const Point& point) const
+  {
+    const index_type axis_idx = static_cast<index_type> (floor(fmod(point.get_coor(axis), extents[axis]) / cell_scale[axis]));
+    return std::min(axis_idx, num_cells[axis] - 1);
+  }
+
+  /// linear offset of the first slot of the cell containing point
+  inline index_type LookupTable_Multi::get_cell_idx(const Point& point) const
+  {
+    return get_axis_idx(0, point) * cell_strides[0] + get_axis_idx(1, point) * cell_strides[1] + get_axis_idx(2, point) * cell_strides[2];
+  }
+
+  /// linear offsets of the cell of point and its periodic neighbours along axis, own cell first
+  /// Returns the number of distinct cells, less than 3 for axes with less than 3 cells.
+  inline uint8_t LookupTable_Multi::get_axis_offsets(const uint8_t& axis, const Point& point, multi_axis_type& axis_offsets) const
+  {
+    const index_type center_idx = get_axis_idx(axis, point);
+    const index_type lower_idx = (center_idx == 0) ? num_cells[axis] - 1 : center_idx - 1;
+    const index_type upper_idx = (center_idx == num_cells[axis] - 1) ? 0 : center_idx + 1;
+
+    uint8_t num_offsets = 0;
+    axis_offsets[num_offsets++] = center_idx * cell_strides[axis];
+    if (lower_idx != center_idx)
+      axis_offsets[num_offsets++] = lower_idx * cell_strides[axis];
+    if (upper_idx != center_idx && upper_idx != lower_idx)
+      axis_offsets[num_offsets++] = upper_idx * cell_strides[axis];
+    return num_offsets;
+  }
+
+  inline LookupTable_Multi::LookupTable_Multi() : total_cells(0), cell_capacity(0), slot_size(1)
+  {
+  }
+
+  inline LookupTable_Multi::LookupTable_Multi(const coordinate_type& new_extents)
+  {
+    extents = new_extents;
+    const double diameter = 2 * DEFAULT_DISC_RADIUS;
+    double max_cell_scale = 0.;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	num_cells[axis] = std::max(static_cast<index_type> (floor(new_extents[axis] / diameter)), static_cast<index_type> (1)); // cells not narrower than one diameter
+	cell_scale[axis] = new_extents[axis] / num_cells[axis];
+	max_cell_scale = std::max(max_cell_scale, cell_scale[axis]);
+      }
+
+    // discs with center in the cell lie inside the cell grown by one diameter, their volume can not exceed it
+    const double disc_volume = M_PI / 6. * diameter * diameter * diameter;
+    const double grown_cell_width = max_cell_scale + diameter;
+    cell_capacity = static_cast<index_type> (floor(grown_cell_width * grown_cell_width * grown_cell_width / disc_volume));
+    slot_size = 1 + cell_capacity;
+
+    // row major, same ordering as the other grids
+    cell_strides[2] = slot_size;
+    cell_strides[1] = num_cells[2] * slot_size;
+    cell_strides[0] = num_cells[1] * num_cells[2] * slot_size;
+    total_cells = num_cells[0] * num_cells[1] * num_cells[2];
+
+    cell_slots.assign(total_cells * slot_size, 0);
+  }
+
+  inline LookupTable_Multi::~LookupTable_Multi()
+  {
+  }
+
+  inline const index_type& LookupTable_Multi::get_cell_capacity() const
+  {
+    return cell_capacity;
+  }
+
+  inline DiscVec LookupTable_Multi::get_neighbouring_discs(const Point& around_point) const
+  {
+    DiscVec neighbouring_discs;
+    get_neighbouring_discs(around_point, neighbouring_discs);
+    return neighbouring_discs;
+  }
+
+  inline void LookupTable_Multi::get_neighbouring_discs(const Point& around_point, DiscVec& neighbouring_discs) const
+  {
+    neighbouring_discs.clear();
+    any_overlap(around_point, NeighbourCollector(neighbouring_discs));
+  }
+
+  /// visits the discs in the 27 cells around the point, own cell first, stops at the first disc the predicate holds for
+  template <class Predicate>
+  inline bool LookupTable_Multi::any_overlap(const Point& around_point, const Predicate& overlap_predicate) const
+  {
+    multi_axis_type i_offsets, j_offsets, k_offsets;
+    const uint8_t num_i = get_axis_offsets(0, around_point, i_offsets);
+    const uint8_t num_j = get_axis_offsets(1, around_point, j_offsets);
+    const uint8_t num_k = get_axis_offsets(2, around_point, k_offsets);
+
+    for (uint8_t i = 0; i < num_i; i++)
+      for (uint8_t j = 0; j < num_j; j++)
+	for (uint8_t k = 0; k < num_k; k++)
+	  {
+	    const disc_id_type* cell = &(cell_slots[i_offsets[i] + j_offsets[j] + k_offsets[k]]);
+	    const disc_id_type num_residents = cell[0];
+	    for (disc_id_type resident = 1; resident <= num_residents; resident++)
+	      {
+		if (overlap_predicate(cell[resident]))
+		  return true;
+	      }
+	  }
+
+    return false;
+  }
+
+  /// always false, a cell is wider than one diameter and its residents need not overlap a disc centered at the point
+  inline bool LookupTable_Multi::cell_occupied(const Point&) const
+  {
+    return false;
+  }
+
+  inline void LookupTable_Multi::remove_disc(const disc_id_type& disc_idx, const Point& disc_center)
+  {
+    disc_id_type* cell = &(cell_slots[get_cell_idx(disc_center)]);
+    disc_id_type* residents_end = cell + 1 + cell[0];
+    disc_id_type* found = std::find(cell + 1, residents_end, disc_idx);
+    assert(found != residents_end);
+
+    // the last resident takes the place of the removed one
+    *found = *(residents_end - 1);
+    cell[0] -= 1;
+  }
+
+  inline void LookupTable_Multi::insert_disc(const disc_id_type& disc_idx, const Point& disc_center)
+  {
+    disc_id_type* cell = &(cell_slots[get_cell_idx(disc_center)]);
+    assert(cell[0] < cell_capacity);
+
+    cell[1 + cell[0]] = disc_idx;
+    cell[0] += 1;
+  }
+
+  /// the disc changed its index, e.g. after swapping it into the place of a removed disc
+  inline void LookupTable_Multi::renumber_disc(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const Point& disc_center)
+  {
+    disc_id_type* cell = &(cell_slots[get_cell_idx(disc_center)]);
+    disc_id_type* residents_end = cell + 1 + cell[0];
+    disc_id_type* found = std::find(cell + 1, residents_end, old_disc_idx);
+    assert(found != residents_end);
+
+    *found = new_disc_idx;
+  }
+
+}
+
+#endif
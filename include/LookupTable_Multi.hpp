@@ -0,0 +1,72 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file LookupTable_Multi.hpp
+ * \brief Lookup table header -- multi occupancy cells
+ *
+ * Pure helper class for HardDiscs implementarion
+ *
+ * Cells are at least one disc diameter wide and hold several discs, so
+ * only the 27 cells around the query point can hold an overlapping disc.
+ * Compared to the one disc per cell grids the grid is about 5 times
+ * coarser per axis, which pays off at low and intermediate densities.
+ *
+ * Each cell is a fixed size slot of the cell array: the number of
+ * residents followed by room for cell_capacity disc indices. The capacity
+ * is the number of discs fitting into the cell volume grown by one
+ * diameter, so a cell can never run full.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef LOOKUPTABLE_MULTI_HPP
+#define LOOKUPTABLE_MULTI_HPP
+
+#include <vector>
+
+#include <boost/array.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <NeighbourStencil.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  /// at most 3 distinct cells per axis around the query point
+  typedef boost::array<index_type, 3> multi_axis_type;
+
+  class LookupTable_Multi
+  {
+  private:
+    coordinate_type extents;
+    coordinate_type cell_scale;
+    multi_index_type num_cells;
+    multi_index_type cell_strides; /// linear offset of one step along each axis, in slots
+    index_type total_cells;
+    index_type cell_capacity;
+    index_type slot_size; /// 1 + cell_capacity
+    std::vector<disc_id_type> cell_slots; /// per cell: number of residents, then the residents
+
+    index_type get_axis_idx(const uint8_t&, const Point&) const;
+    index_type get_cell_idx(const Point&) const;
+    uint8_t get_axis_offsets(const uint8_t&, const Point&, multi_axis_type&) const;
+  public:
+    LookupTable_Multi();
+    LookupTable_Multi(const coordinate_type&);
+    ~LookupTable_Multi();
+    const index_type& get_cell_capacity() const;
+    DiscVec get_neighbouring_discs(const Point&) const;
+    void get_neighbouring_discs(const Point&, DiscVec&) const;
+    template <class Predicate> bool any_overlap(const Point&, const Predicate&) const;
+    bool cell_occupied(const Point&) const;
+    void remove_disc(const disc_id_type&, const Point&);
+    void insert_disc(const disc_id_type&, const Point&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const Point&);
+  };
+
+}
+
+#include <LookupTable_Multi.cpp>
+
+#endif
@@ -0,0 +1,71 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file LookupTable_Packed.hpp
+ * \brief Lookup table header -- coordinates in cell version
+ *
+ * Pure helper class for HardDiscs implementarion
+ *
+ * Same cell geometry as LookupTable_Flat. As a cell holds at most one
+ * disc, the cell stores the center of its disc next to the disc index, so
+ * overlap queries never leave the cell array.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef LOOKUPTABLE_PACKED_HPP
+#define LOOKUPTABLE_PACKED_HPP
+
+#include <vector>
+
+#include <boost/array.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <NeighbourStencil.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  /// center of the resident disc and its index, disc_idx == empty_cell if the cell is empty -- two cells per cache line
+  struct packed_cell_type
+  {
+    double coors[dimensions];
+    disc_id_type disc_idx;
+  } __attribute__ ((aligned (32)));
+
+  class LookupTable_Packed
+  {
+  private:
+    coordinate_type extents;
+    coordinate_type cell_scale;
+    multi_index_type num_cells;
+    multi_index_type cell_strides; /// linear offset of one step along each axis
+    index_type total_cells;
+    packed_cell_type* space_cells; /// total_cells entries, aligned to cache_line_size
+    std::vector<index_type> disc_cells; /// disc index -> cell, only valid for discs in the table
+    NeighbourStencil neighbour_stencil;
+
+    index_type get_cell_idx(const Point&) const;
+
+    // cells are owned by the table, no copies
+    LookupTable_Packed(const LookupTable_Packed&);
+    LookupTable_Packed& operator=(const LookupTable_Packed&);
+  public:
+    LookupTable_Packed();
+    LookupTable_Packed(const coordinate_type&);
+    ~LookupTable_Packed();
+    DiscVec get_neighbouring_discs(const Point&) const;
+    void get_neighbouring_discs(const Point&, DiscVec&) const;
+    template <class Predicate> bool any_overlap(const Point&, const Predicate&) const;
+    bool cell_occupied(const Point&) const;
+    void remove_disc(const disc_id_type&, const Point&);
+    void insert_disc(const disc_id_type&, const Point&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const Point&);
+  };
+
+}
+
+#include <LookupTable_Packed.cpp>
+
+#endif
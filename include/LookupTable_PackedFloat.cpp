@@ -0,0 +1,193 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file LookupTable_PackedFloat.cpp
+ * \brief Lookup Table for Discs in periodic space -- single precision coordinates in cell implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef LOOKUPTABLE_PACKEDFLOAT_HPP
+
+#include <algorithm>
+#include <new>
+
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+
+namespace mcchd {
+
+  inline index_type LookupTable_PackedFloat::get_cell_idx(const Point& point) const
+  {
+    const index_type i_idx = static_cast<index_type> (floor(fmod(point.get_coor(0), extents[0]) / cell_scale[0]));
+    const index_type j_idx = static_cast<index_type> (floor(fmod(point.get_coor(1), extents[1]) / cell_scale[1]));
+    const index_type k_idx = static_cast<index_type> (floor(fmod(point.get_coor(2), extents[2]) / cell_scale[2]));
+
+    return i_idx * cell_strides[0] + j_idx * cell_strides[1] + k_idx * cell_strides[2];
+  }
+
+  inline LookupTable_PackedFloat::LookupTable_PackedFloat() : total_cells(0), space_cells(NULL)
+  {
+  }
+
+  inline LookupTable_PackedFloat::LookupTable_PackedFloat(const coordinate_type& new_extents)
+  {
+    extents = new_extents;
+    const double base_scale = 2 * DEFAULT_DISC_RADIUS;
+    const double cell_width_max = base_scale / sqrt(dimensions); // guarantees only 1 disc per box
+    num_cells[0] = static_cast<index_type> (ceil(new_extents[0] / cell_width_max));
+    num_cells[1] = static_cast<index_type> (ceil(new_extents[1] / cell_width_max));
+    num_cells[2] = static_cast<index_type> (ceil(new_extents[2] / cell_width_max));
+    cell_scale[0] = new_extents[0] / num_cells[0];
+    cell_scale[1] = new_extents[1] / num_cells[1];
+    cell_scale[2] = new_extents[2] / num_cells[2];
+
+    // every float coordinate and each step of the minimum image is off by at most extent * FLT_EPSILON / 2,
+    // which sums up to less than 6 * extent * FLT_EPSILON for the distance
+    const double max_extent = std::max(std::max(extents[0], extents[1]), extents[2]);
+    const double float_margin = 8. * max_extent * FLT_EPSILON;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      float_extents[axis] = static_cast<float> (extents[axis]);
+    float_contact_squared = static_cast<float> ((2. * DEFAULT_DISC_RADIUS + float_margin) * (2. * DEFAULT_DISC_RADIUS + float_margin));
+
+    // row major, same ordering as the multi_array in LookupTable_Fast
+    cell_strides[2] = 1;
+    cell_strides[1] = num_cells[2];
+    cell_strides[0] = num_cells[1] * num_cells[2];
+    total_cells = num_cells[0] * num_cells[1] * num_cells[2];
+    neighbour_stencil = NeighbourStencil(cell_scale, num_cells);
+
+    void* cell_memory = NULL;
+    if (posix_memalign(&cell_memory, cache_line_size, total_cells * sizeof(packed_float_cell_type)) != 0)
+      throw std::bad_alloc();
+    space_cells = static_cast<packed_float_cell_type*> (cell_memory);
+
+    packed_float_cell_type unused_cell;
+    std::fill(unused_cell.coors, unused_cell.coors + dimensions, 0.f);
+    unused_cell.disc_idx = empty_cell;
+    std::fill(space_cells, space_cells + total_cells, unused_cell);
+  }
+
+  inline LookupTable_PackedFloat::~LookupTable_PackedFloat()
+  {
+    free(space_cells);
+  }
+
+  inline DiscVec LookupTable_PackedFloat::get_neighbouring_discs(const Point& around_point) const
+  {
+    DiscVec neighbouring_discs;
+    get_neighbouring_discs(around_point, neighbouring_discs);
+    return neighbouring_discs;
+  }
+
+  inline void LookupTable_PackedFloat::get_neighbouring_discs(const Point& around_point, DiscVec& neighbouring_discs) const
+  {
+    neighbouring_discs.clear();
+    any_overlap(around_point, NeighbourCollector(neighbouring_discs));
+  }
+
+  /// visits the discs around the point nearest cell first, stops at the first disc the predicate holds for
+  /// Discs clearly out of contact by their float centers are skipped, the predicate only gets the index of the others.
+  template <class Predicate>
+  inline bool LookupTable_PackedFloat::any_overlap(const Point& around_point, const Predicate& overlap_predicate) const
+  {
+    multi_index_type center_idx;
+    coordinate_type cell_fractions;
+    for (uint8_t axis = 0; axis < dimensions; axis++)
+      {
+	const double scaled_coor = fmod(around_point.get_coor(axis), extents[axis]) / cell_scale[axis];
+	center_idx[axis] = static_cast<index_type> (floor(scaled_coor));
+	cell_fractions[axis] = scaled_coor - center_idx[axis];
+      }
+
+    // periodically wrapped linear offsets along each axis
+    stencil_axis_type i_offsets, j_offsets, k_offsets;
+    neighbour_stencil.get_axis_offsets(0, center_idx[0], num_cells[0], cell_strides[0], i_offsets);
+    neighbour_stencil.get_axis_offsets(1, center_idx[1], num_cells[1], cell_strides[1], j_offsets);
+    neighbour_stencil.get_axis_offsets(2, center_idx[2], num_cells[2], cell_strides[2], k_offsets);
+
+    const float query_x = static_cast<float> (around_point.get_coor(0));
+    const float query_y = static_cast<float> (around_point.get_coor(1));
+    const float query_z = static_cast<float> (around_point.get_coor(2));
+
+    // only cells which can hold an overlapping disc, nearest first
+    const stencil_type& stencil = neighbour_stencil.get_stencil(cell_fractions);
+    const std::size_t stencil_size = stencil.size();
+    for (std::size_t entry = 0; entry < stencil_size; entry++)
+      {
+	if (entry + stencil_prefetch_distance < stencil_size)
+	  {
+	    const stencil_entry_type& ahead = stencil[entry + stencil_prefetch_distance];
+	    __builtin_prefetch(space_cells + i_offsets[ahead[0]] + j_offsets[ahead[1]] + k_offsets[ahead[2]]);
+	  }
+
+	const stencil_entry_type& cell = stencil[entry];
+	const packed_float_cell_type& found_cell = space_cells[i_offsets[cell[0]] + j_offsets[cell[1]] + k_offsets[cell[2]]];
+
+	if (found_cell.disc_idx == empty_cell)
+	  continue;
+
+	const float d_x = fabsf(found_cell.coors[0] - query_x);
+	const float d_y = fabsf(found_cell.coors[1] - query_y);
+	const float d_z = fabsf(found_cell.coors[2] - query_z);
+	const float d_x_pbc = std::min(d_x, float_extents[0] - d_x);
+	const float d_y_pbc = std::min(d_y, float_extents[1] - d_y);
+	const float d_z_pbc = std::min(d_z, float_extents[2] - d_z);
+	if (d_x_pbc*d_x_pbc + d_y_pbc*d_y_pbc + d_z_pbc*d_z_pbc >= float_contact_squared)
+	  continue;
+
+	// close to contact or overlapping -- exact decision in double precision
+	if (overlap_predicate(found_cell.disc_idx))
+	  return true;
+      }
+
+    return false;
+  }
+
+  /// a disc in the cell of the point surely overlaps a disc centered at the point, the cell diagonal is one diameter
+  inline bool LookupTable_PackedFloat::cell_occupied(const Point& point) const
+  {
+    return space_cells[get_cell_idx(point)].disc_idx != empty_cell;
+  }
+
+  inline void LookupTable_PackedFloat::remove_disc(const disc_id_type& disc_idx, const Point&)
+  {
+    packed_float_cell_type& disc_cell = space_cells[disc_cells[disc_idx]];
+    assert(disc_cell.disc_idx == disc_idx);
+    disc_cell.disc_idx = empty_cell;
+  }
+
+  inline void LookupTable_PackedFloat::insert_disc(const disc_id_type& disc_idx, const Point& disc_center)
+  {
+    const index_type cell_idx = get_cell_idx(disc_center);
+    packed_float_cell_type& disc_cell = space_cells[cell_idx];
+    assert(disc_cell.disc_idx == empty_cell);
+    assert(disc_idx != empty_cell);
+
+    disc_cell.coors[0] = static_cast<float> (disc_center.get_coor(0));
+    disc_cell.coors[1] = static_cast<float> (disc_center.get_coor(1));
+    disc_cell.coors[2] = static_cast<float> (disc_center.get_coor(2));
+    disc_cell.disc_idx = disc_idx;
+
+    if (disc_idx >= disc_cells.size())
+      disc_cells.resize(disc_idx + 1, 0);
+    disc_cells[disc_idx] = cell_idx;
+  }
+
+  /// the disc changed its index, e.g. after swapping it into the place of a removed disc
+  inline void LookupTable_PackedFloat::renumber_disc(const disc_id_type& old_disc_idx, const disc_id_type& new_disc_idx, const Point&)
+  {
+    const index_type cell_idx = disc_cells[old_disc_idx];
+    assert(space_cells[cell_idx].disc_idx == old_disc_idx);
+    space_cells[cell_idx].disc_idx = new_disc_idx;
+
+    if (new_disc_idx >= disc_cells.size())
+      disc_cells.resize(new_disc_idx + 1, 0);
+    disc_cells[new_disc_idx] = cell_idx;
+  }
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file LookupTable_PackedFloat.hpp
+ * \brief Lookup table header -- coordinates in cell version, single precision
+ *
+ * Pure helper class for HardDiscs implementarion
+ *
+ * Same as LookupTable_Packed, but the cell keeps the disc center in
+ * single precision, 16 bytes per cell. The float distance only sorts out
+ * discs which are clearly farther away than the contact distance, with a
+ * margin covering the float rounding. All other discs are handed to the
+ * predicate by index, which decides on the double precision centers, so
+ * the result is the same as with the double tables.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef LOOKUPTABLE_PACKEDFLOAT_HPP
+#define LOOKUPTABLE_PACKEDFLOAT_HPP
+
+#include <vector>
+
+#include <boost/array.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <NeighbourStencil.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  /// center of the resident disc and its index, disc_idx == empty_cell if the cell is empty -- four cells per cache line
+  struct packed_float_cell_type
+  {
+    float coors[dimensions];
+    disc_id_type disc_idx;
+  } __attribute__ ((aligned (16)));
+
+  class LookupTable_PackedFloat
+  {
+  private:
+    coordinate_type extents;
+    boost::array<float, dimensions> float_extents;
+    float float_contact_squared; /// squared contact distance plus the rounding margin
+    coordinate_type cell_scale;
+    multi_index_type num_cells;
+    multi_index_type cell_strides; /// linear offset of one step along each axis
+    index_type total_cells;
+    packed_float_cell_type* space_cells; /// total_cells entries, aligned to cache_line_size
+    std::vector<index_type> disc_cells; /// disc index -> cell, only valid for discs in the table
+    NeighbourStencil neighbour_stencil;
+
+    index_type get_cell_idx(const Point&) const;
+
+    // cells are owned by the table, no copies
+    LookupTable_PackedFloat(const LookupTable_PackedFloat&);
+    LookupTable_PackedFloat& operator=(const LookupTable_PackedFloat&);
+  public:
+    LookupTable_PackedFloat();
+    LookupTable_PackedFloat(const coordinate_type&);
+    ~LookupTable_PackedFloat();
+    DiscVec get_neighbouring_discs(const Point&) const;
+    void get_neighbouring_discs(const Point&, DiscVec&) const;
+    template <class Predicate> bool any_overlap(const Point&, const Predicate&) const;
+    bool cell_occupied(const Point&) const;
+    void remove_disc(const disc_id_type&, const Point&);
+    void insert_disc(const disc_id_type&, const Point&);
+    void renumber_disc(const disc_id_type&, const disc_id_type&, const Point&);
+  };
+
+}
+
+#include <LookupTable_PackedFloat.cpp>
+
+#endif
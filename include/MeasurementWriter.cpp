@@ -0,0 +1,111 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file MeasurementWriter.cpp
+ * \brief Buffered measurement output with a background writer -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef MEASUREMENTWRITER_HPP
+
+namespace mcchd
+{
+  template <class ValueType>
+  inline void MeasurementWriter<ValueType>::write_block(const std::vector<ValueType>& block)
+  {
+    if (binary)
+      output_fstream.write(reinterpret_cast<const char*> (&block[0]), block.size() * sizeof(ValueType));
+    else
+      for (typename std::vector<ValueType>::const_iterator value_cit = block.begin(); value_cit != block.end(); value_cit++)
+	output_fstream << *value_cit << '\n';
+  }
+
+  /// body of the writer thread, the file is only touched outside the lock
+  template <class ValueType>
+  inline void MeasurementWriter<ValueType>::write_pending_blocks()
+  {
+    std::vector<ValueType> block;
+    std::unique_lock<std::mutex> lock(block_mutex);
+    while (true)
+      {
+	while (pending_block.empty() && !stopping)
+	  block_condition.wait(lock);
+	if (pending_block.empty())
+	  return;
+
+	block.swap(pending_block);
+	writing = true;
+	lock.unlock();
+	write_block(block);
+	const bool block_failed = !output_fstream;
+	block.clear();
+	lock.lock();
+
+	writing = false;
+	write_failed = write_failed || block_failed;
+	block_condition.notify_all();
+      }
+  }
+
+  /// waits for the writer to take the previous block, then passes the filling one
+  template <class ValueType>
+  inline void MeasurementWriter<ValueType>::hand_over_block()
+  {
+    std::unique_lock<std::mutex> lock(block_mutex);
+    while (!pending_block.empty())
+      block_condition.wait(lock);
+    pending_block.swap(filling_block);
+    block_condition.notify_all();
+  }
+
+  template <class ValueType>
+  inline MeasurementWriter<ValueType>::MeasurementWriter(const std::string& filename, const bool& new_binary, const std::size_t& new_block_size)
+    : output_fstream(filename.c_str(), new_binary ? (std::ios::out | std::ios::app | std::ios::binary) : (std::ios::out | std::ios::app)),
+      binary(new_binary), block_size(new_block_size), writing(false), stopping(false), write_failed(false)
+  {
+    if (!output_fstream)
+      throw measurement_write_exception();
+
+    filling_block.reserve(block_size);
+    pending_block.reserve(block_size);
+    writer_thread = std::thread(&MeasurementWriter<ValueType>::write_pending_blocks, this);
+  }
+
+  template <class ValueType>
+  inline MeasurementWriter<ValueType>::~MeasurementWriter()
+  {
+    hand_over_block();
+    {
+      std::lock_guard<std::mutex> lock(block_mutex);
+      stopping = true;
+    }
+    block_condition.notify_all();
+    writer_thread.join();
+    output_fstream.flush();
+  }
+
+  template <class ValueType>
+  inline void MeasurementWriter<ValueType>::append(const ValueType& value)
+  {
+    filling_block.push_back(value);
+    if (filling_block.size() >= block_size)
+      hand_over_block();
+  }
+
+  /// returns after everything appended so far is in the file
+  template <class ValueType>
+  inline void MeasurementWriter<ValueType>::flush()
+  {
+    hand_over_block();
+    std::unique_lock<std::mutex> lock(block_mutex);
+    while (!pending_block.empty() || writing)
+      block_condition.wait(lock);
+    output_fstream.flush();
+    if (write_failed || !output_fstream)
+      throw measurement_write_exception();
+  }
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file MeasurementWriter.hpp
+ * \brief Buffered measurement output with a background writer -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * append() only stores the value in a block in memory. A full block is
+ * handed to a writer thread, which appends it to the file opened once in
+ * the constructor, while the simulation fills the second block. flush()
+ * writes everything appended so far, the destructor flushes as well.
+ *
+ * Text output has one value per line. Binary output has the raw values in
+ * native byte order and without any header.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef MEASUREMENTWRITER_HPP
+#define MEASUREMENTWRITER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace mcchd
+{
+  /// values per block, a block is written in one go
+  const std::size_t default_measurement_block_size = 65536;
+
+  class measurement_write_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "Could not write the measurement file.";
+    }
+  };
+
+  template <class ValueType>
+  class MeasurementWriter
+  {
+  private:
+    std::ofstream output_fstream;
+    bool binary;
+    std::size_t block_size;
+    /// filled by append()
+    std::vector<ValueType> filling_block;
+    /// handed to the writer thread, empty once the writer has taken it
+    std::vector<ValueType> pending_block;
+    /// the writer thread is busy with a block taken from pending_block
+    bool writing;
+    bool stopping;
+    bool write_failed;
+    std::mutex block_mutex;
+    std::condition_variable block_condition;
+    std::thread writer_thread;
+
+    void write_block(const std::vector<ValueType>&);
+    void write_pending_blocks();
+    void hand_over_block();
+
+    MeasurementWriter(const MeasurementWriter&);
+    MeasurementWriter& operator=(const MeasurementWriter&);
+  public:
+    MeasurementWriter(const std::string&, const bool& = false, const std::size_t& = default_measurement_block_size);
+    ~MeasurementWriter();
+    void append(const ValueType&);
+    void flush();
+  };
+
+}
+
+#include <MeasurementWriter.cpp>
+
+#endif
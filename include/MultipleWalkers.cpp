@@ -0,0 +1,35 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file MultipleWalkers.cpp
+ * \brief Shared histograms of several Wang Landau walkers -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef MULTIPLEWALKERS_HPP
+
+namespace mcchd
+{
+  /// shared histogram plus what every walker added to it since the walkers got it, bins missing in shared count as 0
+  /// Histogram values of the walkers never fall below the shared ones, so unsigned counters are fine.
+  template <class Histogram>
+  inline Histogram merge_walker_deltas(const Histogram& shared_histogram, const std::vector<Histogram>& walker_histograms)
+  {
+    Histogram merged_histogram = shared_histogram;
+    for (typename std::vector<Histogram>::const_iterator walker_cit = walker_histograms.begin(); walker_cit != walker_histograms.end(); walker_cit++)
+      for (typename Histogram::const_iterator bin_cit = walker_cit->begin(); bin_cit != walker_cit->end(); bin_cit++)
+	{
+	  typename Histogram::const_iterator shared_cit = shared_histogram.find(bin_cit->first);
+	  if (shared_cit == shared_histogram.end())
+	    merged_histogram[bin_cit->first] += bin_cit->second;
+	  else
+	    merged_histogram[bin_cit->first] += bin_cit->second - shared_cit->second;
+	}
+
+    return merged_histogram;
+  }
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file MultipleWalkers.hpp
+ * \brief Shared histograms of several Wang Landau walkers -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * Several walkers sample the same energy range, each one updates its own
+ * copy of the entropy estimate and the incidence counter during a sweep.
+ * At the end of the sweep merge_walker_deltas adds the changes of all
+ * walkers to the shared histograms, which are then handed back to every
+ * walker. So no histogram is written by two threads.
+ *
+ * The histograms only need the interface of std::map.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef MULTIPLEWALKERS_HPP
+#define MULTIPLEWALKERS_HPP
+
+#include <vector>
+
+namespace mcchd
+{
+  template <class Histogram> Histogram merge_walker_deltas(const Histogram&, const std::vector<Histogram>&);
+}
+
+#include <MultipleWalkers.cpp>
+
+#endif
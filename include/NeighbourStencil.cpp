@@ -0,0 +1,165 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file NeighbourStencil.cpp
+ * \brief Pruned neighbour cell stencil implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef NEIGHBOURSTENCIL_HPP
+
+#include <algorithm>
+#include <utility>
+
+#include <cmath>
+
+namespace mcchd {
+
+  inline NeighbourCollector::NeighbourCollector(DiscVec& new_neighbouring_discs) : neighbouring_discs(&new_neighbouring_discs)
+  {
+  }
+
+  inline bool NeighbourCollector::operator()(const disc_id_type& neighbour) const
+  {
+    neighbouring_discs->push_back(neighbour);
+    return false;
+  }
+
+  inline bool NeighbourCollector::operator()(const disc_id_type& neighbour, const Point&) const
+  {
+    return (*this)(neighbour);
+  }
+
+  inline NeighbourStencil::NeighbourStencil()
+  {
+  }
+
+  inline NeighbourStencil::NeighbourStencil(const coordinate_type& cell_scale, const multi_index_type& num_cells)
+  {
+    const double diameter = 2 * DEFAULT_DISC_RADIUS;
+    // cell indices are computed in floating point, do not trust the last bits of a gap
+    const double safety_margin = 1e-9;
+
+    // axis_gaps[axis][sub cell][offset + cell range]: smallest distance between sub cell and offset cell along axis, negative if offset is not used
+    boost::array<boost::array<boost::array<double, max_stencil_width>, stencil_subdivisions>, dimensions> axis_gaps;
+
+    for (int axis = 0; axis < dimensions; axis++)
+      {
+	const index_type range = static_cast<index_type> (floor(diameter / cell_scale[axis])) + 1;
+	if (range > max_stencil_range)
+	  throw bad_extents_exception_stencil();
+	cell_ranges[axis] = range;
+
+	for (int sub_cell = 0; sub_cell < stencil_subdivisions; sub_cell++)
+	  {
+	    const double sub_cell_low = cell_scale[axis] * sub_cell / stencil_subdivisions;
+	    const double sub_cell_high = cell_scale[axis] * (sub_cell + 1) / stencil_subdivisions;
+	    boost::array<double, max_stencil_width>& gaps = axis_gaps[axis][sub_cell];
+
+	    for (index_type offset = -range; offset <= range; offset++)
+	      {
+		double gap = 0.;
+		if (offset > 0)
+		  gap = offset * cell_scale[axis] - sub_cell_high;
+		else if (offset < 0)
+		  gap = sub_cell_low + (- offset - 1) * cell_scale[axis];
+		gaps[offset + range] = std::max(0., gap - safety_margin * cell_scale[axis]);
+	      }
+
+	    // small boxes: several offsets hit the same cell, keep only the nearest image
+	    for (index_type offset = -range; offset <= range; offset++)
+	      {
+		for (index_type other_offset = -range; other_offset <= range; other_offset++)
+		  {
+		    const bool same_cell = (other_offset != offset) && ((offset - other_offset) % num_cells[axis] == 0);
+		    const double gap = gaps[offset + range];
+		    const double other_gap = gaps[other_offset + range];
+		    if (same_cell && other_gap >= 0. && (other_gap < gap || (other_gap == gap && other_offset < offset)))
+		      {
+			gaps[offset + range] = -1.;
+			break;
+		      }
+		  }
+	      }
+	  }
+      }
+
+    const int num_sub_cells = stencil_subdivisions * stencil_subdivisions * stencil_subdivisions;
+    sub_cell_stencils.resize(num_sub_cells);
+    for (int sub_cell = 0; sub_cell < num_sub_cells; sub_cell++)
+      {
+	const int sub_i = sub_cell / (stencil_subdivisions * stencil_subdivisions);
+	const int sub_j = (sub_cell / stencil_subdivisions) % stencil_subdivisions;
+	const int sub_k = sub_cell % stencil_subdivisions;
+
+	// (squared gap, squared offset) -> entry; sorting on this key puts the nearest cells first
+	std::vector<std::pair<std::pair<double, index_type>, stencil_entry_type> > candidates;
+	for (index_type i = 0; i <= 2 * cell_ranges[0]; i++)
+	  {
+	    const double gap_i = axis_gaps[0][sub_i][i];
+	    for (index_type j = 0; j <= 2 * cell_ranges[1]; j++)
+	      {
+		const double gap_j = axis_gaps[1][sub_j][j];
+		for (index_type k = 0; k <= 2 * cell_ranges[2]; k++)
+		  {
+		    const double gap_k = axis_gaps[2][sub_k][k];
+		    if (gap_i < 0. || gap_j < 0. || gap_k < 0.)
+		      continue;
+
+		    const double gap_squared = gap_i*gap_i + gap_j*gap_j + gap_k*gap_k;
+		    if (gap_squared >= diameter * diameter)
+		      continue;
+
+		    const index_type d_i = i - cell_ranges[0];
+		    const index_type d_j = j - cell_ranges[1];
+		    const index_type d_k = k - cell_ranges[2];
+		    stencil_entry_type entry = {{static_cast<uint8_t> (i), static_cast<uint8_t> (j), static_cast<uint8_t> (k)}};
+		    candidates.push_back(std::make_pair(std::make_pair(gap_squared, d_i*d_i + d_j*d_j + d_k*d_k), entry));
+		  }
+	      }
+	  }
+
+	std::stable_sort(candidates.begin(), candidates.end());
+	for (std::size_t candidate = 0; candidate < candidates.size(); candidate++)
+	  sub_cell_stencils[sub_cell].push_back(candidates[candidate].second);
+      }
+  }
+
+  inline NeighbourStencil::~NeighbourStencil()
+  {
+  }
+
+  inline const multi_index_type& NeighbourStencil::get_cell_ranges() const
+  {
+    return cell_ranges;
+  }
+
+  /// cell_fractions: position of the query point inside its cell, in units of the cell scale
+  inline const stencil_type& NeighbourStencil::get_stencil(const coordinate_type& cell_fractions) const
+  {
+    const int sub_i = std::min(static_cast<int> (cell_fractions[0] * stencil_subdivisions), stencil_subdivisions - 1);
+    const int sub_j = std::min(static_cast<int> (cell_fractions[1] * stencil_subdivisions), stencil_subdivisions - 1);
+    const int sub_k = std::min(static_cast<int> (cell_fractions[2] * stencil_subdivisions), stencil_subdivisions - 1);
+
+    return sub_cell_stencils[(sub_i * stencil_subdivisions + sub_j) * stencil_subdivisions + sub_k];
+  }
+
+  /// fills axis_offsets[offset + cell range] with the linear offset of the periodically wrapped cell
+  inline void NeighbourStencil::get_axis_offsets(const uint8_t& axis, const index_type& center_idx, const index_type& num_axis_cells, const index_type& stride, stencil_axis_type& axis_offsets) const
+  {
+    const index_type range = cell_ranges[axis];
+    for (index_type offset = -range; offset <= range; offset++)
+      {
+	index_type idx = center_idx + offset;
+	while (idx < 0)
+	  idx += num_axis_cells;
+	while (idx >= num_axis_cells)
+	  idx -= num_axis_cells;
+	axis_offsets[offset + range] = idx * stride;
+      }
+  }
+
+}
+
+#endif
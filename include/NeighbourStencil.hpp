@@ -0,0 +1,81 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file NeighbourStencil.hpp
+ * \brief Pruned neighbour cell stencil header
+ *
+ * Pure helper class for the LookupTable implementations
+ *
+ * Every cell is split into stencil_subdivisions^3 sub cells. For each sub
+ * cell the stencil lists only those neighbour cells which can contain a
+ * disc center closer than one diameter to some point in the sub cell,
+ * ordered nearest cell first.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef NEIGHBOURSTENCIL_HPP
+#define NEIGHBOURSTENCIL_HPP
+
+#include <cstdint>
+#include <vector>
+#include <exception>
+
+#include <boost/array.hpp>
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+  const int stencil_subdivisions = 4;
+  const int max_stencil_range = 4;
+  const int max_stencil_width = 2 * max_stencil_range + 1;
+  /// how many stencil entries ahead the cell memory gets prefetched
+  const std::size_t stencil_prefetch_distance = 8;
+
+  /// per axis: offset + cell range, i.e. index into the wrapped cell lists of a query
+  typedef boost::array<uint8_t, dimensions> stencil_entry_type;
+  typedef std::vector<stencil_entry_type> stencil_type;
+  typedef boost::array<index_type, max_stencil_width> stencil_axis_type;
+
+  class bad_extents_exception_stencil : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "Bad extents, cells are too small for the neighbour stencil. x, y, z should be larger than or equal to 1.";
+    }
+  };
+
+  /// any_overlap predicate which never stops and collects every disc index it is shown
+  class NeighbourCollector
+  {
+  private:
+    DiscVec* neighbouring_discs;
+  public:
+    NeighbourCollector(DiscVec&);
+    bool operator()(const disc_id_type&) const;
+    bool operator()(const disc_id_type&, const Point&) const;
+  };
+
+  class NeighbourStencil
+  {
+  private:
+    multi_index_type cell_ranges;
+    std::vector<stencil_type> sub_cell_stencils;
+
+  public:
+    NeighbourStencil();
+    NeighbourStencil(const coordinate_type&, const multi_index_type&);
+    ~NeighbourStencil();
+    const multi_index_type& get_cell_ranges() const;
+    const stencil_type& get_stencil(const coordinate_type&) const;
+    void get_axis_offsets(const uint8_t&, const index_type&, const index_type&, const index_type&, stencil_axis_type&) const;
+  };
+
+}
+
+#include <NeighbourStencil.cpp>
+
+#endif
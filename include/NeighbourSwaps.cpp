@@ -0,0 +1,40 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file NeighbourSwaps.cpp
+ * \brief Configuration swaps between neighbouring replicas -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef NEIGHBOURSWAPS_HPP
+
+#include <cmath>
+
+namespace mcchd
+{
+  /// one round of swap tries, neighbours with the lower replica at an even index try after even rounds, the others after odd rounds
+  /// log_probability(lower_idx, lower_configuration, upper_configuration) is the log of the acceptance probability of the pair lower_idx, lower_idx + 1,
+  /// minus infinity refuses the swap. Tries and accepted swaps of a pair are counted at its lower index.
+  template <class Configuration, class Simulation, class LogProbability, class Rng>
+  inline void swap_neighbours(std::vector<Simulation*>& replicas, const uint64_t& round, const LogProbability& log_probability, Rng& rng,
+			      std::vector<uint64_t>& swaps_tried, std::vector<uint64_t>& swaps_accepted)
+  {
+    for (std::size_t lower_idx = round % 2; lower_idx + 1 < replicas.size(); lower_idx += 2)
+      {
+	Configuration* lower_configuration = replicas[lower_idx]->get_config_space();
+	Configuration* upper_configuration = replicas[lower_idx + 1]->get_config_space();
+	swaps_tried[lower_idx]++;
+
+	const double pair_log_probability = log_probability(lower_idx, *lower_configuration, *upper_configuration);
+	if (pair_log_probability >= 0. || rng.random_double() < exp(pair_log_probability))
+	  {
+	    replicas[lower_idx]->set_config_space(upper_configuration);
+	    replicas[lower_idx + 1]->set_config_space(lower_configuration);
+	    swaps_accepted[lower_idx]++;
+	  }
+      }
+  }
+}
+
+#endif
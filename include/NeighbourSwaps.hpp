@@ -0,0 +1,31 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file NeighbourSwaps.hpp
+ * \brief Configuration swaps between neighbouring replicas -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * Parallel tempering and replica exchange Wang Landau both run a row of
+ * simulations, of which neighbours try to swap their configurations after
+ * every round. swap_neighbours makes one round of tries, the frontend only
+ * supplies the log of the acceptance probability of a pair.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef NEIGHBOURSWAPS_HPP
+#define NEIGHBOURSWAPS_HPP
+
+#include <vector>
+#include <cstdint>
+
+namespace mcchd
+{
+  template <class Configuration, class Simulation, class LogProbability, class Rng>
+  void swap_neighbours(std::vector<Simulation*>&, const uint64_t&, const LogProbability&, Rng&, std::vector<uint64_t>&, std::vector<uint64_t>&);
+}
+
+#include <NeighbourSwaps.cpp>
+
+#endif
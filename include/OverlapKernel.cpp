@@ -0,0 +1,116 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file OverlapKernel.cpp
+ * \brief Batched periodic overlap test -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef OVERLAPKERNEL_HPP
+
+#include <algorithm>
+
+#include <cmath>
+
+namespace mcchd {
+
+  /// same test as Disc::is_overlapping with extents, on squared distances
+  inline bool is_overlapping_periodic(const Point& query, const Point& center, const coordinate_type& extents)
+  {
+    const double contact_squared = 4. * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS;
+    const double d_x = fabs(center.get_coor(0) - query.get_coor(0));
+    const double d_y = fabs(center.get_coor(1) - query.get_coor(1));
+    const double d_z = fabs(center.get_coor(2) - query.get_coor(2));
+    const double d_x_pbc = std::min(d_x, extents[0] - d_x);
+    const double d_y_pbc = std::min(d_y, extents[1] - d_y);
+    const double d_z_pbc = std::min(d_z, extents[2] - d_z);
+    return d_x_pbc*d_x_pbc + d_y_pbc*d_y_pbc + d_z_pbc*d_z_pbc < contact_squared;
+  }
+
+  /// index of the first of the count centers (xs[i], ys[i], zs[i]) overlapping a disc centered at query, count if there is none
+  inline std::size_t find_overlap_batch(const Point& query, const double* xs, const double* ys, const double* zs, const std::size_t& count, const coordinate_type& extents)
+  {
+    const double contact_squared = 4. * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS;
+    std::size_t idx = 0;
+
+#if defined(__AVX512F__)
+    const __m512i abs_mask = _mm512_set1_epi64(0x7fffffffffffffffLL);
+    const __m512d query_x = _mm512_set1_pd(query.get_coor(0));
+    const __m512d query_y = _mm512_set1_pd(query.get_coor(1));
+    const __m512d query_z = _mm512_set1_pd(query.get_coor(2));
+    const __m512d extent_x = _mm512_set1_pd(extents[0]);
+    const __m512d extent_y = _mm512_set1_pd(extents[1]);
+    const __m512d extent_z = _mm512_set1_pd(extents[2]);
+    const __m512d contact = _mm512_set1_pd(contact_squared);
+    for (; idx + 8 <= count; idx += 8)
+      {
+	__m512d d_x = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(_mm512_sub_pd(_mm512_loadu_pd(xs + idx), query_x)), abs_mask));
+	__m512d d_y = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(_mm512_sub_pd(_mm512_loadu_pd(ys + idx), query_y)), abs_mask));
+	__m512d d_z = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(_mm512_sub_pd(_mm512_loadu_pd(zs + idx), query_z)), abs_mask));
+	d_x = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(_mm512_sub_pd(extent_x, d_x), d_x, _CMP_LT_OQ), d_x, _mm512_sub_pd(extent_x, d_x));
+	d_y = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(_mm512_sub_pd(extent_y, d_y), d_y, _CMP_LT_OQ), d_y, _mm512_sub_pd(extent_y, d_y));
+	d_z = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(_mm512_sub_pd(extent_z, d_z), d_z, _CMP_LT_OQ), d_z, _mm512_sub_pd(extent_z, d_z));
+	const __m512d d_squared = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(d_x, d_x), _mm512_mul_pd(d_y, d_y)), _mm512_mul_pd(d_z, d_z));
+	const __mmask8 overlapping = _mm512_cmp_pd_mask(d_squared, contact, _CMP_LT_OQ);
+	if (overlapping != 0)
+	  return idx + __builtin_ctz(overlapping);
+      }
+#elif defined(__AVX2__)
+    const __m256d sign_mask = _mm256_set1_pd(-0.);
+    const __m256d query_x = _mm256_set1_pd(query.get_coor(0));
+    const __m256d query_y = _mm256_set1_pd(query.get_coor(1));
+    const __m256d query_z = _mm256_set1_pd(query.get_coor(2));
+    const __m256d extent_x = _mm256_set1_pd(extents[0]);
+    const __m256d extent_y = _mm256_set1_pd(extents[1]);
+    const __m256d extent_z = _mm256_set1_pd(extents[2]);
+    const __m256d contact = _mm256_set1_pd(contact_squared);
+    for (; idx + 4 <= count; idx += 4)
+      {
+	__m256d d_x = _mm256_andnot_pd(sign_mask, _mm256_sub_pd(_mm256_loadu_pd(xs + idx), query_x));
+	__m256d d_y = _mm256_andnot_pd(sign_mask, _mm256_sub_pd(_mm256_loadu_pd(ys + idx), query_y));
+	__m256d d_z = _mm256_andnot_pd(sign_mask, _mm256_sub_pd(_mm256_loadu_pd(zs + idx), query_z));
+	d_x = _mm256_min_pd(_mm256_sub_pd(extent_x, d_x), d_x);
+	d_y = _mm256_min_pd(_mm256_sub_pd(extent_y, d_y), d_y);
+	d_z = _mm256_min_pd(_mm256_sub_pd(extent_z, d_z), d_z);
+	const __m256d d_squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(d_x, d_x), _mm256_mul_pd(d_y, d_y)), _mm256_mul_pd(d_z, d_z));
+	const int overlapping = _mm256_movemask_pd(_mm256_cmp_pd(d_squared, contact, _CMP_LT_OQ));
+	if (overlapping != 0)
+	  return idx + __builtin_ctz(overlapping);
+      }
+#elif defined(__SSE2__)
+    const __m128d sign_mask = _mm_set1_pd(-0.);
+    const __m128d query_x = _mm_set1_pd(query.get_coor(0));
+    const __m128d query_y = _mm_set1_pd(query.get_coor(1));
+    const __m128d query_z = _mm_set1_pd(query.get_coor(2));
+    const __m128d extent_x = _mm_set1_pd(extents[0]);
+    const __m128d extent_y = _mm_set1_pd(extents[1]);
+    const __m128d extent_z = _mm_set1_pd(extents[2]);
+    const __m128d contact = _mm_set1_pd(contact_squared);
+    for (; idx + 2 <= count; idx += 2)
+      {
+	__m128d d_x = _mm_andnot_pd(sign_mask, _mm_sub_pd(_mm_loadu_pd(xs + idx), query_x));
+	__m128d d_y = _mm_andnot_pd(sign_mask, _mm_sub_pd(_mm_loadu_pd(ys + idx), query_y));
+	__m128d d_z = _mm_andnot_pd(sign_mask, _mm_sub_pd(_mm_loadu_pd(zs + idx), query_z));
+	d_x = _mm_min_pd(_mm_sub_pd(extent_x, d_x), d_x);
+	d_y = _mm_min_pd(_mm_sub_pd(extent_y, d_y), d_y);
+	d_z = _mm_min_pd(_mm_sub_pd(extent_z, d_z), d_z);
+	const __m128d d_squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(d_x, d_x), _mm_mul_pd(d_y, d_y)), _mm_mul_pd(d_z, d_z));
+	const int overlapping = _mm_movemask_pd(_mm_cmplt_pd(d_squared, contact));
+	if (overlapping != 0)
+	  return idx + __builtin_ctz(overlapping);
+      }
+#endif
+
+    // scalar fallback and remainder
+    for (; idx < count; idx++)
+      if (is_overlapping_periodic(query, Point(xs[idx], ys[idx], zs[idx]), extents))
+	return idx;
+
+    return count;
+  }
+
+
+}
+
+#endif
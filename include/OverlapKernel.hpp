@@ -0,0 +1,50 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file OverlapKernel.hpp
+ * \brief Batched periodic overlap test of one disc against many centers
+ *
+ * Pure helper for the HardDiscs implementarion
+ *
+ * The instruction set is chosen at build time from the compiler flags
+ * (-march=native): AVX-512 tests 8 centers per instruction, AVX2 4,
+ * SSE2 2, otherwise a scalar loop is used. All variants use the branchless
+ * minimum image min(|d|, L - |d|) and compare squared distances against
+ * (2 * DEFAULT_DISC_RADIUS)^2.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef OVERLAPKERNEL_HPP
+#define OVERLAPKERNEL_HPP
+
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <Point.hpp>
+#include <Disc.hpp>
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd {
+
+#if defined(__AVX512F__)
+  const std::size_t overlap_kernel_width = 8;
+#elif defined(__AVX2__)
+  const std::size_t overlap_kernel_width = 4;
+#elif defined(__SSE2__)
+  const std::size_t overlap_kernel_width = 2;
+#else
+  const std::size_t overlap_kernel_width = 1;
+#endif
+
+  bool is_overlapping_periodic(const Point&, const Point&, const coordinate_type&);
+  std::size_t find_overlap_batch(const Point&, const double*, const double*, const double*, const std::size_t&, const coordinate_type&);
+
+}
+
+#include <OverlapKernel.cpp>
+
+#endif
@@ -0,0 +1,35 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file ParallelTempering.cpp
+ * \brief Parallel tempering in the chemical potential -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef PARALLELTEMPERING_HPP
+
+namespace mcchd
+{
+  /// num_replicas equally spaced beta from lower to upper, both included
+  inline std::vector<double> beta_ladder(const double& lower, const double& upper, const uint32_t& num_replicas)
+  {
+    if (num_replicas == 0 || (num_replicas > 1 && !(upper > lower)))
+      throw bad_ladder_exception();
+
+    std::vector<double> ladder(num_replicas, lower);
+    for (uint32_t replica_idx = 1; replica_idx < num_replicas; replica_idx++)
+      ladder[replica_idx] = lower + (upper - lower) * replica_idx / (num_replicas - 1);
+    return ladder;
+  }
+
+  /// log of the acceptance probability for the replica at beta_one, now with num_discs_one, and the one at beta_two to swap configurations
+  /// With weights exp(-beta N) the swap changes the log weight by (beta_one - beta_two) (N_one - N_two).
+  inline double tempering_log_probability(const double& beta_one, const double& beta_two, const disc_id_type& num_discs_one, const disc_id_type& num_discs_two)
+  {
+    return (beta_one - beta_two) * (static_cast<double> (num_discs_one) - static_cast<double> (num_discs_two));
+  }
+
+}
+
+#endif
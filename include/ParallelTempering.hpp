@@ -0,0 +1,56 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file ParallelTempering.hpp
+ * \brief Parallel tempering in the chemical potential -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * One grand canonical replica per beta of a ladder samples with weight
+ * exp(-beta N), as Mocasinns' do_metropolis_steps does with the number of
+ * discs as energy, so beta is minus beta mu. Replicas of neighbouring beta
+ * swap their configurations from time to time, see NeighbourSwaps.hpp, with
+ * the probability given by tempering_log_probability, so a replica trapped
+ * in a dense or dilute state can escape through the others.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef PARALLELTEMPERING_HPP
+#define PARALLELTEMPERING_HPP
+
+#include <vector>
+#include <exception>
+
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd
+{
+  class bad_ladder_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "A ladder of several beta needs an upper beta above the lower one.";
+    }
+  };
+
+  std::vector<double> beta_ladder(const double&, const double&, const uint32_t&);
+  double tempering_log_probability(const double&, const double&, const disc_id_type&, const disc_id_type&);
+
+  /// swap probability of neighbouring replicas of a ladder, for swap_neighbours
+  struct TemperingSwapProbability
+  {
+    const std::vector<double>& ladder;
+
+    TemperingSwapProbability(const std::vector<double>& new_ladder) : ladder(new_ladder) {}
+    template <class Configuration> double operator()(const std::size_t& lower_idx, const Configuration& lower_configuration, const Configuration& upper_configuration) const
+    {
+      return tempering_log_probability(ladder[lower_idx], ladder[lower_idx + 1], lower_configuration.get_number_of_discs(), upper_configuration.get_number_of_discs());
+    }
+  };
+
+}
+
+#include <ParallelTempering.cpp>
+
+#endif
@@ -0,0 +1,97 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file ReplicaExchange.cpp
+ * \brief Energy windows for replica exchange Wang Landau -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef REPLICAEXCHANGE_HPP
+
+#include <cmath>
+
+namespace mcchd
+{
+  /// num_windows windows of equal width covering lower to upper, neighbours share the fraction overlap of a window
+  inline std::vector<EnergyWindow> split_energy_range(const energy_type& lower, const energy_type& upper, const uint32_t& num_windows, const double& overlap)
+  {
+    if (num_windows == 0 || overlap < 0. || overlap >= 1. || upper < lower)
+      throw bad_windows_exception();
+
+    const double width = (upper - lower) / (1. + (num_windows - 1) * (1. - overlap));
+    std::vector<EnergyWindow> windows(num_windows);
+    for (uint32_t window_idx = 0; window_idx < num_windows; window_idx++)
+      {
+	const double window_start = lower + window_idx * width * (1. - overlap);
+	windows[window_idx].lower = static_cast<energy_type> (floor(window_start + 0.5));
+	windows[window_idx].upper = static_cast<energy_type> (floor(window_start + width + 0.5));
+      }
+    windows.back().upper = upper;
+
+    // an exchange needs two energies both neighbours can take
+    for (uint32_t window_idx = 1; window_idx < num_windows; window_idx++)
+      if (windows[window_idx - 1].upper - windows[window_idx].lower < 1 || windows[window_idx].lower <= windows[window_idx - 1].lower)
+	throw bad_windows_exception();
+
+    return windows;
+  }
+
+  /// log of the acceptance probability for walker one, now at energy_one, and walker two, now at energy_two, to swap configurations
+  /// An energy not sampled yet has the initial entropy 0.
+  template <class Histogram>
+  inline double exchange_log_probability(const Histogram& log_dos_one, const Histogram& log_dos_two, const energy_type& energy_one, const energy_type& energy_two)
+  {
+    typename Histogram::const_iterator one_at_one = log_dos_one.find(energy_one);
+    typename Histogram::const_iterator one_at_two = log_dos_one.find(energy_two);
+    typename Histogram::const_iterator two_at_one = log_dos_two.find(energy_one);
+    typename Histogram::const_iterator two_at_two = log_dos_two.find(energy_two);
+
+    double log_probability = 0.;
+    log_probability += (one_at_one != log_dos_one.end()) ? one_at_one->second : 0.;
+    log_probability -= (one_at_two != log_dos_one.end()) ? one_at_two->second : 0.;
+    log_probability += (two_at_two != log_dos_two.end()) ? two_at_two->second : 0.;
+    log_probability -= (two_at_one != log_dos_two.end()) ? two_at_one->second : 0.;
+    return log_probability;
+  }
+
+  /// joins the entropies of the windows, each window is shifted onto the joined ones below by the mean difference over their common energies
+  /// Below the middle of an overlap the lower window is taken, above it the upper one.
+  template <class Histogram>
+  inline Histogram stitch_log_dos(const std::vector<Histogram>& window_log_dos, const std::vector<EnergyWindow>& windows)
+  {
+    Histogram joined_log_dos = window_log_dos[0];
+    for (std::size_t window_idx = 1; window_idx < windows.size(); window_idx++)
+      {
+	const Histogram& upper_log_dos = window_log_dos[window_idx];
+	const energy_type overlap_lower = windows[window_idx].lower;
+	const energy_type overlap_upper = windows[window_idx - 1].upper;
+
+	double sum_difference = 0.;
+	uint32_t common_energies = 0;
+	for (typename Histogram::const_iterator upper_cit = upper_log_dos.begin(); upper_cit != upper_log_dos.end(); upper_cit++)
+	  {
+	    if (upper_cit->first < overlap_lower || upper_cit->first > overlap_upper)
+	      continue;
+	    typename Histogram::const_iterator joined_cit = joined_log_dos.find(upper_cit->first);
+	    if (joined_cit == joined_log_dos.end())
+	      continue;
+	    sum_difference += joined_cit->second - upper_cit->second;
+	    common_energies++;
+	  }
+	if (common_energies == 0)
+	  throw stitch_exception();
+	const double shift = sum_difference / common_energies;
+
+	const energy_type join_energy = overlap_lower + (overlap_upper - overlap_lower) / 2;
+	for (typename Histogram::const_iterator upper_cit = upper_log_dos.begin(); upper_cit != upper_log_dos.end(); upper_cit++)
+	  if (upper_cit->first > join_energy)
+	    joined_log_dos[upper_cit->first] = upper_cit->second + shift;
+      }
+
+    return joined_log_dos;
+  }
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file ReplicaExchange.hpp
+ * \brief Energy windows for replica exchange Wang Landau -- header
+ *
+ * Pure helper for the program frontends
+ *
+ * The energy range is split into windows which overlap their neighbours.
+ * One walker samples the entropy of each window, walkers of neighbouring
+ * windows exchange their configurations from time to time, with the
+ * probability given by exchange_log_probability. In the end,
+ * stitch_log_dos joins the entropies of all windows into one curve.
+ *
+ * The histograms only need the interface of std::map, so Histocrete works
+ * as well as std::map.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef REPLICAEXCHANGE_HPP
+#define REPLICAEXCHANGE_HPP
+
+#include <vector>
+#include <exception>
+
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd
+{
+  const double default_window_overlap = 0.75;
+
+  class bad_windows_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "The energy range is too small for that many windows with that overlap.";
+    }
+  };
+
+  class stitch_exception : public std::exception
+  {
+    virtual const char* what() const throw()
+    {
+      return "Two neighbouring windows share no sampled energy, their entropies cannot be joined.";
+    }
+  };
+
+  /// energies from lower to upper, both included
+  struct EnergyWindow
+  {
+    energy_type lower;
+    energy_type upper;
+  };
+
+  std::vector<EnergyWindow> split_energy_range(const energy_type&, const energy_type&, const uint32_t&, const double& = default_window_overlap);
+  template <class Histogram> double exchange_log_probability(const Histogram&, const Histogram&, const energy_type&, const energy_type&);
+  template <class Histogram> Histogram stitch_log_dos(const std::vector<Histogram>&, const std::vector<EnergyWindow>&);
+
+}
+
+#include <ReplicaExchange.cpp>
+
+#endif
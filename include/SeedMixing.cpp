@@ -0,0 +1,24 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file SeedMixing.cpp
+ * \brief Seeds of several random number streams from one seed -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef SEEDMIXING_HPP
+
+namespace mcchd
+{
+  /// seed of stream stream_idx of a run seeded with seed
+  inline uint32_t mix_seed(const uint32_t& seed, const uint64_t& stream_idx)
+  {
+    uint64_t mixed = ((static_cast<uint64_t> (seed) << 32) ^ stream_idx) + 0x9e3779b97f4a7c15ULL;
+    mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<uint32_t> (mixed ^ (mixed >> 31));
+  }
+}
+
+#endif
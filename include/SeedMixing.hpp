@@ -0,0 +1,28 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file SeedMixing.hpp
+ * \brief Seeds of several random number streams from one seed -- header
+ *
+ * Parallel chains, replicas, walkers, threads and ranks each need their own
+ * stream, and a checkpointed run needs a fresh stream after every
+ * checkpoint. mix_seed derives the seed of stream stream_idx from the seed
+ * of the run with the splitmix64 finaliser, so the Mersenne twisters of
+ * neighbouring streams start from unrelated states, unlike seed + index.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef SEEDMIXING_HPP
+#define SEEDMIXING_HPP
+
+#include <cstdint>
+
+namespace mcchd
+{
+  uint32_t mix_seed(const uint32_t&, const uint64_t&);
+}
+
+#include <SeedMixing.cpp>
+
+#endif
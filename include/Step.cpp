@@ -70,7 +70,7 @@ namespace mcchd
     if (is_remove)
       return hard_disc_configuration_space->get_number_of_discs() > 0;
     else
-      return (! hard_disc_configuration_space->is_overlapping(Disc(target_coor, -1))); // -1 is unused test disc id
+      return (! hard_disc_configuration_space->is_overlapping(Disc(target_coor, no_disc))); // no_disc takes the occupied cell shortcut
   }
 
   template <class HardDiscSpace>
@@ -107,17 +107,22 @@ namespace mcchd
   double Step<HardDiscSpace>::selection_probability_factor() const
   {
     const double num_discs = static_cast<double> (hard_disc_configuration_space->get_number_of_discs());
-    const double volume = hard_disc_configuration_space->get_volume();
     const double sphere_volume = M_PI * 4. / 3. * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS * DEFAULT_DISC_RADIUS;
     const double thermal_wavelength_pow_3 = sphere_volume;
-    const double pre_factor_VL3 = volume / thermal_wavelength_pow_3;
 
     if (is_move)
       return 1.;
+    // the insertion volume is the whole box, or the free cells with cavity bias
+    // A removal is weighted with the free cells of the configuration it leads to, i.e. those of its reverse insertion.
     if (is_remove)
-      return pre_factor_VL3 / num_discs;
+      return hard_disc_configuration_space->get_insertion_volume_without(to_be_removed) / thermal_wavelength_pow_3 / num_discs;
     else
-      return (num_discs + 1.) / pre_factor_VL3;
+      {
+	const double pre_factor_VL3 = hard_disc_configuration_space->get_insertion_volume() / thermal_wavelength_pow_3;
+	if (pre_factor_VL3 == 0.)
+	  return 0.;
+	return (num_discs + 1.) / pre_factor_VL3;
+      }
   }
 
 
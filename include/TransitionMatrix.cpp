@@ -0,0 +1,76 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file TransitionMatrix.cpp
+ * \brief Transition matrix over the number of discs -- implementation
+ *
+ * \author Johannes Knauf
+ */
+
+#ifdef TRANSITIONMATRIX_HPP
+
+#include <cmath>
+
+namespace mcchd
+{
+  inline TransitionMatrix::TransitionMatrix()
+  {
+  }
+
+  inline TransitionMatrix::~TransitionMatrix()
+  {
+  }
+
+  /// one step proposed at num_discs, changing it by delta_N, accepted with acceptance_probability at infinite temperature
+  inline void TransitionMatrix::record(const disc_id_type& num_discs, const energy_type& delta_N, const double& acceptance_probability)
+  {
+    if (num_discs >= proposed_steps.size())
+      {
+	proposed_steps.resize(num_discs + 1, 0.);
+	up_probabilities.resize(num_discs + 1, 0.);
+	down_probabilities.resize(num_discs + 1, 0.);
+      }
+
+    proposed_steps[num_discs] += 1.;
+    if (delta_N > 0)
+      up_probabilities[num_discs] += acceptance_probability;
+    else if (delta_N < 0)
+      down_probabilities[num_discs] += acceptance_probability;
+  }
+
+  /// estimated probability to go from num_discs to num_discs + delta_N in one step, delta_N is 1 or -1
+  inline double TransitionMatrix::get_transition_probability(const disc_id_type& num_discs, const energy_type& delta_N) const
+  {
+    if (num_discs >= proposed_steps.size() || proposed_steps[num_discs] == 0.)
+      return 0.;
+    return (delta_N > 0 ? up_probabilities[num_discs] : down_probabilities[num_discs]) / proposed_steps[num_discs];
+  }
+
+  /// writes the entropy estimate into log_dos, for the longest run of N from the lowest one recorded which has transitions both ways
+  /// The estimate is shifted onto the value log_dos has at that lowest N, if any, so it can replace parts of another estimate.
+  template <class Histogram>
+  inline void TransitionMatrix::fill_log_density_of_states(Histogram& log_dos) const
+  {
+    disc_id_type num_discs = 0;
+    while (num_discs < proposed_steps.size() && proposed_steps[num_discs] == 0.)
+      num_discs++;
+    if (num_discs == proposed_steps.size())
+      return;
+
+    typename Histogram::const_iterator start_cit = log_dos.find(num_discs);
+    double entropy = (start_cit != log_dos.end()) ? start_cit->second : 0.;
+    log_dos[num_discs] = entropy;
+    for (; num_discs + 1 < proposed_steps.size(); num_discs++)
+      {
+	const double up_probability = get_transition_probability(num_discs, 1);
+	const double down_probability = get_transition_probability(num_discs + 1, -1);
+	if (up_probability == 0. || down_probability == 0.)
+	  break;
+	entropy += log(up_probability) - log(down_probability);
+	log_dos[num_discs + 1] = entropy;
+      }
+  }
+
+}
+
+#endif
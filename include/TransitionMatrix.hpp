@@ -0,0 +1,46 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file TransitionMatrix.hpp
+ * \brief Transition matrix over the number of discs -- header
+ *
+ * Collects, for every number of discs N, how many steps were proposed and
+ * the summed infinite temperature acceptance probabilities of the proposed
+ * insertions and removals, accepted or not. As the matrix is tridiagonal,
+ * the entropy follows from detailed balance,
+ *   S(N+1) - S(N) = ln P(N -> N+1) - ln P(N+1 -> N),
+ * which converges without the flat histogram iterations of Wang Landau.
+ *
+ * HardDiscs records every proposed step, if a TransitionMatrix is set.
+ *
+ * \author Johannes Knauf
+ */
+
+#ifndef TRANSITIONMATRIX_HPP
+#define TRANSITIONMATRIX_HPP
+
+#include <vector>
+
+#include <mcchd_typedefs.hpp>
+
+namespace mcchd
+{
+  class TransitionMatrix
+  {
+  private:
+    std::vector<double> proposed_steps; /// by N
+    std::vector<double> up_probabilities; /// by N, summed acceptance probabilities of the insertions
+    std::vector<double> down_probabilities; /// by N, summed acceptance probabilities of the removals
+  public:
+    TransitionMatrix();
+    ~TransitionMatrix();
+    void record(const disc_id_type&, const energy_type&, const double&);
+    double get_transition_probability(const disc_id_type&, const energy_type&) const;
+    template <class Histogram> void fill_log_density_of_states(Histogram&) const;
+  };
+
+}
+
+#include <TransitionMatrix.cpp>
+
+#endif
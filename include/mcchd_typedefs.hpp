@@ -22,13 +22,23 @@
 namespace mcchd
 {
   const int dimensions = 3;
+  const std::size_t cache_line_size = 64;
 
-  typedef boost::multi_array<Disc*, dimensions> Cells3D;
-  typedef std::vector<const Disc*> DiscVec;
+  /// marks a cell without disc
+  const disc_id_type empty_cell = no_disc;
+
+  typedef boost::multi_array<disc_id_type, dimensions> Cells3D;
+  /// disc indices, see DiscPositions
+  typedef std::vector<disc_id_type> DiscVec;
   typedef boost::multi_array_types::index index_type;
   typedef boost::array<index_type, dimensions> multi_index_type;
 
-  typedef std::vector<Disc*> DiscCollection;
+  /// fraction of the box extent in units of 2^-32, see DiscPositions_FixedPoint
+  typedef uint32_t fixed_coor_type;
+  typedef boost::array<fixed_coor_type, dimensions> fixed_coordinate_type;
+  /// 2^-32, one fixed point step as fraction of the extent
+  const double fixed_step_fraction = 1. / 4294967296.;
+
   typedef uint64_t time_type;
   typedef int32_t energy_type;
 
@@ -0,0 +1,130 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file mcchd_benchmark_tables.cpp
+ * \brief Benchmark of the lookup tables over a range of densities
+ *
+ * For every packing fraction a bulk system is filled with insertions and
+ * moves, then the time per proposed and checked step is measured for each
+ * lookup table. All tables see the same Markov chain, as they take the
+ * same decisions.
+ *
+ * For usage info execute:
+ *  mcchd_benchmark_tables --help
+ *
+ * \author Johannes Knauf
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#include <boost/program_options.hpp>
+
+#include <mocasinns/random/boost_random.hpp>
+#include <HardDiscs.hpp>
+#include <LookupTable_Fast.hpp>
+#include <LookupTable_Flat.hpp>
+#include <LookupTable_Multi.hpp>
+#include <CollisionFunctor_SingularDefects.hpp>
+
+namespace boost_po = boost::program_options;
+
+typedef Mocasinns::Random::Boost_MT19937 RngType;
+
+/// fills the box up to the packing fraction and returns the nanoseconds per proposed and checked step
+/// Removals are never executed, so the density stays put while measuring. Dense systems may stop short
+/// of the requested packing fraction, the one reached is stored in reached_fraction.
+template <class LookupTable>
+double time_per_step(const double& edge, const double& packing_fraction, const uint32_t& num_steps, const uint32_t& seed, double& reached_fraction)
+{
+  typedef mcchd::HardDiscs<mcchd::CF_Bulk, LookupTable> ConfigurationType;
+  typedef mcchd::Step<ConfigurationType> StepType;
+
+  const mcchd::coordinate_type extents = {{edge, edge, edge}};
+  const double disc_volume = M_PI * 4. / 3. * mcchd::DEFAULT_DISC_RADIUS * mcchd::DEFAULT_DISC_RADIUS * mcchd::DEFAULT_DISC_RADIUS;
+  const mcchd::disc_id_type target_discs = static_cast<mcchd::disc_id_type> (packing_fraction * edge * edge * edge / disc_volume);
+
+  ConfigurationType configuration(extents);
+  RngType rng;
+  rng.set_seed(seed);
+
+  for (uint64_t fill_step = 0; configuration.get_number_of_discs() < target_discs && fill_step < 1000 * static_cast<uint64_t> (target_discs); fill_step++)
+    {
+      StepType step = configuration.propose_step(&rng);
+      if (! step.is_remove_step() && step.is_executable())
+	step.execute();
+    }
+  reached_fraction = configuration.get_number_of_discs() * disc_volume / (edge * edge * edge);
+
+  const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+  for (uint32_t step_idx = 0; step_idx < num_steps; step_idx++)
+    {
+      StepType step = configuration.propose_step(&rng);
+      if (step.is_move_step() && step.is_executable())
+	step.execute();
+    }
+  const std::chrono::high_resolution_clock::time_point stop = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds> (stop - start).count() / static_cast<double> (num_steps);
+}
+
+int main(int argc, char* argv[])
+{
+  try
+    {
+      boost_po::options_description option_desc("Available options");
+      option_desc.add_options()
+        ("help,h", "Prints this message.")
+        ("edge,L", boost_po::value<double>()->default_value(20.), "Edge length of the cubic box.")
+        ("packing_fraction,p", boost_po::value<std::vector<double> >()->multitoken(), "Packing fractions to measure at, default 0.05 0.1 0.2 0.3 0.4.")
+        ("steps,n", boost_po::value<uint32_t>()->default_value(1000000), "Number of timed steps per table and packing fraction.")
+        ("seed,S", boost_po::value<uint32_t>()->default_value(1), "Seed of the Random number generator.")
+        ;
+
+      boost_po::variables_map option_arguments;
+      boost_po::store (boost_po::parse_command_line (argc, argv, option_desc), option_arguments);
+      boost_po::notify (option_arguments);
+
+      if (option_arguments.count("help"))
+        {
+	  std::cerr << "Usage: mcchd_benchmark_tables [options]" << std::endl;
+	  std::cerr << option_desc;
+          return 0;
+        }
+
+      const double edge = option_arguments["edge"].as<double>();
+      const uint32_t num_steps = option_arguments["steps"].as<uint32_t>();
+      const uint32_t seed = option_arguments["seed"].as<uint32_t>();
+      std::vector<double> packing_fractions;
+      if (option_arguments.count("packing_fraction"))
+	packing_fractions = option_arguments["packing_fraction"].as<std::vector<double> >();
+      else
+	{
+	  const double default_fractions[] = {0.05, 0.1, 0.2, 0.3, 0.4};
+	  packing_fractions.assign(default_fractions, default_fractions + 5);
+	}
+
+      std::cout << "# ns per step, box edge " << edge << ", " << num_steps << " steps" << std::endl;
+      std::cout << "# packing_fraction\treached\tFast\tFlat\tMulti" << std::endl;
+      for (std::vector<double>::const_iterator fraction_cit = packing_fractions.begin(); fraction_cit != packing_fractions.end(); fraction_cit++)
+	{
+	  double reached_fraction = 0.;
+	  const double fast_time = time_per_step<mcchd::LookupTable_Fast>(edge, *fraction_cit, num_steps, seed, reached_fraction);
+	  const double flat_time = time_per_step<mcchd::LookupTable_Flat>(edge, *fraction_cit, num_steps, seed, reached_fraction);
+	  const double multi_time = time_per_step<mcchd::LookupTable_Multi>(edge, *fraction_cit, num_steps, seed, reached_fraction);
+	  std::cout << std::setprecision(3) << *fraction_cit << "\t" << reached_fraction;
+	  std::cout << std::setprecision(4) << "\t" << fast_time << "\t" << flat_time << "\t" << multi_time << std::endl;
+	}
+    }
+  catch (std::exception &exceptionX)
+    {
+      std::cout << exceptionX.what() << std::endl;
+      return 1;
+    }
+
+  return 0;
+}
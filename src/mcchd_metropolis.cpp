@@ -14,7 +14,12 @@
 #include <iomanip>
 #include <fstream>
 #include <limits>
+#include <vector>
+#include <mutex>
 #include <cstdlib>
+#include <cmath>
+
+#include <unistd.h>
 
 #include <boost/log/trivial.hpp>
 #include <boost/log/core.hpp>
@@ -39,35 +44,99 @@
 #include <mocasinns/random/boost_random.hpp>
 #include <mocasinns/metropolis.hpp>
 #include <HardDiscs.hpp>
-#include <CollisionFunctor_SingularDefects.hpp>
-#include <CollisionFunctor_NodalSurfaces.hpp>
-#include <CollisionFunctor_SimpleGeometries.hpp>
+#include <LookupTable_Flat.hpp>
+#include <ContainerDispatch.hpp>
+#include <MeasurementWriter.hpp>
+#include <IndependentChains.hpp>
+#include <ParallelTempering.hpp>
+#include <NeighbourSwaps.hpp>
+#include <CheckerboardSweeps.hpp>
 
 namespace boost_po = boost::program_options;
 namespace boost_fs = boost::filesystem;
 
-#ifndef CONTAINER_NAME
-#define CONTAINER_NAME Bulk
-#endif
-
-// double layering of definitions is necessary because of c preprocessor replacement rules
-#define PASTER(x,y) x ## _ ## y
-#define EVALUATOR(x,y) PASTER(x,y)
-#define CONTAINER_TYPE EVALUATOR(mcchd::CF, CONTAINER_NAME)
-
-
 typedef uint64_t signal_flag_t;
 typedef mcchd::disc_id_type energy_type;
 typedef Mocasinns::Random::Boost_MT19937 RngType;
-typedef CONTAINER_TYPE ContainerType;
 typedef Mocasinns::Histograms::Histocrete<energy_type, long long int> IncidenceHistogramType;
 typedef Mocasinns::Histograms::Histocrete<energy_type, double> HistogramType;
-typedef mcchd::HardDiscs<ContainerType> ConfigurationType;
-typedef mcchd::Step<ConfigurationType> StepType;
-typedef Mocasinns::Simulation<ConfigurationType, RngType> ParentSimulationType;
-typedef Mocasinns::Metropolis<ConfigurationType, StepType, RngType> SimulationType;
+typedef mcchd::ChainMeasurement<energy_type> ChainMeasurementType;
+
+/// simulation types for one container, which is chosen at runtime with --container
+template <class ContainerType>
+struct SimulationTypes
+{
+  typedef mcchd::HardDiscs<ContainerType, mcchd::LookupTable_Flat> ConfigurationType;
+  typedef mcchd::Step<ConfigurationType> StepType;
+  typedef Mocasinns::Simulation<ConfigurationType, RngType> ParentSimulationType;
+  typedef Mocasinns::Metropolis<ConfigurationType, StepType, RngType> SimulationType;
+};
+
+class TemperingOptionsException: public std::exception
+{
+  virtual const char* what() const throw()
+  {
+    return "Parallel tempering needs beta_upper above beta and cannot be combined with chains.";
+  }
+} tempering_options_exception;
+
+class ParallelSweepsOptionsException: public std::exception
+{
+  virtual const char* what() const throw()
+  {
+    return "Parallel sweeps cannot be combined with chains or replicas, which run in parallel already.";
+  }
+} parallel_sweeps_options_exception;
 
 static std::string output_directory;
+/// sink of measurement_handler, flushed by the SIGTERM handler
+static mcchd::MeasurementWriter<energy_type>* measurement_writer = 0;
+
+/// measurements of all chains of a --chains run, shared by the pool threads
+struct ChainMeasurements
+{
+  mcchd::MeasurementWriter<ChainMeasurementType>* writer;
+  std::vector<mcchd::RunningAverage> averages; /// by chain
+  uint64_t num_taken;
+  uint64_t num_total;
+  std::vector<double> log_percentages;
+  std::vector<double>::const_iterator next_percentage;
+  std::mutex mutex; /// guards everything above
+};
+/// flushed by the SIGTERM handler, 0 outside of --chains runs
+static ChainMeasurements* chain_measurements = 0;
+/// measurement sinks of a --replicas run by beta, flushed by the SIGTERM handler
+static std::vector<mcchd::MeasurementWriter<energy_type>*> replica_writers;
+/// taken by the first thread handling SIGTERM, the others wait there until _exit
+static std::mutex termination_mutex;
+
+/// fractions of the measurements at which the progress is logged
+std::vector<double> progress_log_percentages()
+{
+  std::vector<double> log_percentages;
+  log_percentages.push_back(0.001);
+  log_percentages.push_back(0.002);
+  log_percentages.push_back(0.005);
+  log_percentages.push_back(0.01);
+  log_percentages.push_back(0.015);
+  log_percentages.push_back(0.02);
+  log_percentages.push_back(0.025);
+  log_percentages.push_back(0.05);
+  log_percentages.push_back(0.075);
+  log_percentages.push_back(0.1);
+  log_percentages.push_back(0.15);
+  log_percentages.push_back(0.2);
+  log_percentages.push_back(0.25);
+  log_percentages.push_back(0.3);
+  log_percentages.push_back(0.4);
+  log_percentages.push_back(0.5);
+  log_percentages.push_back(0.6);
+  log_percentages.push_back(0.7);
+  log_percentages.push_back(0.8);
+  log_percentages.push_back(0.9);
+  log_percentages.push_back(1.);
+  return log_percentages;
+}
 
 void init_logging()
 {
@@ -91,50 +160,265 @@ void init_logging()
   BOOST_LOG_TRIVIAL(info) << "Logging facilities successfully initialized.";
 }
 
-void append_value_to_file(std::string output_file, energy_type energy)
+/// pooled average of all chains, the caller holds the lock
+mcchd::RunningAverage pooled_average(const ChainMeasurements& measurements)
 {
-  std::ofstream *output_fstream = new std::ofstream;
-  output_fstream->open(output_file.c_str(), std::fstream::app);
-  
-  if (!(*output_fstream)) // Is output_fstream OK?
-    {
-      throw 5;
-    }
-  
-  (*output_fstream) << energy << std::endl;
-  delete output_fstream;
+  mcchd::RunningAverage pooled;
+  for (std::vector<mcchd::RunningAverage>::const_iterator average_cit = measurements.averages.begin(); average_cit != measurements.averages.end(); average_cit++)
+    pooled.merge(*average_cit);
+  return pooled;
+}
+
+/// per chain and pooled averages to averages.out, also written when terminated by SIGTERM
+void write_chain_averages(const ChainMeasurements& measurements)
+{
+  const uint32_t num_chains = measurements.averages.size();
+  std::ofstream averages_fstream((output_directory + "/averages.out").c_str());
+  averages_fstream << "# chain\tmeasurements\tmean\tvariance" << std::endl;
+  for (uint32_t chain_idx = 0; chain_idx < num_chains; chain_idx++)
+    averages_fstream << chain_idx << '\t' << measurements.averages[chain_idx].get_count() << '\t' << measurements.averages[chain_idx].get_mean() << '\t' << measurements.averages[chain_idx].get_variance() << std::endl;
+  const mcchd::RunningAverage pooled = pooled_average(measurements);
+  averages_fstream << "pooled\t" << pooled.get_count() << '\t' << pooled.get_mean() << '\t' << pooled.get_variance() << std::endl;
+  BOOST_LOG_TRIVIAL(info) << "Pooled <N> of " << num_chains << " chains: " << pooled.get_mean() << ", variance " << pooled.get_variance();
 }
 
-void handle_sig_usr1(ParentSimulationType*)
+template <class ContainerType>
+void handle_sig_usr1(typename SimulationTypes<ContainerType>::ParentSimulationType*)
 {
   BOOST_LOG_TRIVIAL(debug) << "Caught SIGUSR1. No action defined.";
 }
 
-void handle_sig_usr2(ParentSimulationType*)
+template <class ContainerType>
+void handle_sig_usr2(typename SimulationTypes<ContainerType>::ParentSimulationType*)
 {
   BOOST_LOG_TRIVIAL(debug) << "Caught SIGUSR2. No action defined.";
 }
 
-void handle_sig_term(ParentSimulationType* parent_simulation)
+template <class ContainerType>
+void handle_sig_term(typename SimulationTypes<ContainerType>::ParentSimulationType* parent_simulation)
 {
   BOOST_LOG_TRIVIAL(debug) << "Caught SIGTERM.";
-  BOOST_LOG_TRIVIAL(debug) << "No special handling for SIGTERM yet. Calling SIGUSR1 handler for writing a snapshot before exiting.";
-  handle_sig_usr1(parent_simulation);
-  exit(2);
+  BOOST_LOG_TRIVIAL(debug) << "Calling SIGUSR1 handler for writing a snapshot and flushing the measurements before exiting.";
+  termination_mutex.lock();
+  handle_sig_usr1<ContainerType>(parent_simulation);
+  if (measurement_writer)
+    measurement_writer->flush();
+  for (std::size_t replica_idx = 0; replica_idx < replica_writers.size(); replica_idx++)
+    replica_writers[replica_idx]->flush();
+  if (chain_measurements)
+    {
+      // the other chains wait at the lock until exit
+      chain_measurements->mutex.lock();
+      chain_measurements->writer->flush();
+      write_chain_averages(*chain_measurements);
+    }
+  // the other threads are still running, static destructors must not run underneath them
+  _exit(2);
 }
 
-void measurement_handler(ParentSimulationType* parent_simulation)
+template <class ContainerType>
+void measurement_handler(typename SimulationTypes<ContainerType>::ParentSimulationType* parent_simulation)
 {
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
   SimulationType* metropolis_simulation = static_cast<SimulationType*> (parent_simulation);
   const energy_type current_energy = metropolis_simulation->get_config_space()->energy();
 
-  std::string output_file = output_directory + "/measurements.out";
+  measurement_writer->append(current_energy);
+}
+
+template <class ContainerType>
+void chain_measurement_handler(const uint32_t& chain_idx, typename SimulationTypes<ContainerType>::ParentSimulationType* parent_simulation)
+{
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
+  SimulationType* metropolis_simulation = static_cast<SimulationType*> (parent_simulation);
+  ChainMeasurementType measurement;
+  measurement.chain = chain_idx;
+  measurement.value = metropolis_simulation->get_config_space()->energy();
+
+  std::lock_guard<std::mutex> lock(chain_measurements->mutex);
+  chain_measurements->writer->append(measurement);
+  chain_measurements->averages[chain_idx].add(measurement.value);
+  chain_measurements->num_taken++;
+
+  const double percentage = (double)chain_measurements->num_taken / (double)chain_measurements->num_total;
+  if (chain_measurements->next_percentage != chain_measurements->log_percentages.end() && percentage >= *chain_measurements->next_percentage)
+    {
+      const mcchd::RunningAverage pooled = pooled_average(*chain_measurements);
+      BOOST_LOG_TRIVIAL(info) << "Simulation is  " << percentage << " finished. Pooled <N> = " << pooled.get_mean();
+      while (chain_measurements->next_percentage != chain_measurements->log_percentages.end() && percentage >= *chain_measurements->next_percentage)
+	chain_measurements->next_percentage++;
+    }
+}
+
+/// one independent chain with its own configuration, simulation and random number stream, run by a pool thread
+template <class ContainerType>
+struct ChainRun
+{
+  typedef typename SimulationTypes<ContainerType>::ConfigurationType ConfigurationType;
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
+
+  const typename SimulationType::Parameters& parameters;
+  mcchd::coordinate_type extents;
+  bool cavity_bias;
+  uint32_t seed;
+  double beta;
+
+  ChainRun(const typename SimulationType::Parameters& new_parameters, const mcchd::coordinate_type& new_extents, const bool& new_cavity_bias, const uint32_t& new_seed, const double& new_beta)
+    : parameters(new_parameters), extents(new_extents), cavity_bias(new_cavity_bias), seed(new_seed), beta(new_beta) {}
+
+  void operator()(const uint32_t& chain_idx)
+  {
+    ConfigurationType hard_sphere_configuration(extents);
+    hard_sphere_configuration.set_cavity_bias(cavity_bias);
+    SimulationType metropolis_simulation(parameters, &hard_sphere_configuration);
+    metropolis_simulation.set_random_seed(mcchd::mix_seed(seed, chain_idx));
+    metropolis_simulation.signal_handler_sigterm.connect(handle_sig_term<ContainerType>);
+
+    metropolis_simulation.do_metropolis_steps(parameters.relaxation_steps, beta);
+    for (uint32_t i = 0; i < parameters.measurement_number; i++)
+      {
+	metropolis_simulation.do_metropolis_steps(parameters.steps_between_measurement, beta);
+	chain_measurement_handler<ContainerType>(chain_idx, &metropolis_simulation);
+      }
+    BOOST_LOG_TRIVIAL(debug) << "Chain " << chain_idx << " finished.";
+  }
+};
+
+/// num_chains independent chains on a pool of num_threads threads, their measurements go to one file tagged with the chain index
+/// Mean and variance of N of every chain and of all chains pooled are written to averages.out.
+template <class ContainerType>
+void run_chains(const typename SimulationTypes<ContainerType>::SimulationType::Parameters& parameters, const mcchd::coordinate_type& extents,
+		const bool& cavity_bias, const uint32_t& seed, const double& beta, const uint32_t& num_chains, const uint32_t& num_threads, const bool& binary_output)
+{
+  ChainMeasurements measurements;
+  const std::string measurement_file = output_directory + (binary_output ? "/measurements.bin" : "/measurements.out");
+  measurements.writer = new mcchd::MeasurementWriter<ChainMeasurementType>(measurement_file, binary_output);
+  measurements.averages.resize(num_chains);
+  measurements.num_taken = 0;
+  measurements.num_total = static_cast<uint64_t> (num_chains) * parameters.measurement_number;
+  measurements.log_percentages = progress_log_percentages();
+  measurements.next_percentage = measurements.log_percentages.begin();
+  chain_measurements = &measurements;
+
+  BOOST_LOG_TRIVIAL(info) << "Running " << num_chains << " independent chains with " << parameters.relaxation_steps << " relaxation steps each.";
+  ChainRun<ContainerType> chain_run(parameters, extents, cavity_bias, seed, beta);
+  mcchd::run_on_thread_pool(chain_run, num_chains, num_threads);
+
+  measurements.writer->flush();
+  chain_measurements = 0;
+  delete measurements.writer;
+
+  write_chain_averages(measurements);
+}
+
+/// steps of every replica between two swaps, the replicas are shared out to the pool threads
+template <class SimulationType>
+struct ReplicaSteps
+{
+  std::vector<SimulationType*>& replicas;
+  const std::vector<double>& ladder;
+  uint32_t steps;
+
+  ReplicaSteps(std::vector<SimulationType*>& new_replicas, const std::vector<double>& new_ladder, const uint32_t& new_steps) : replicas(new_replicas), ladder(new_ladder), steps(new_steps) {}
+  void operator()(const uint32_t& replica_idx)
+  {
+    replicas[replica_idx]->do_metropolis_steps(steps, ladder[replica_idx]);
+  }
+};
+
+/// parallel tempering in beta, i.e. minus beta mu: one replica per beta of the ladder, all step in parallel, then each replica is measured and neighbours may swap configurations
+/// The measurements of each beta go to their own file, the swap acceptance rates to swap_rates.out.
+template <class ContainerType>
+void run_parallel_tempering(const typename SimulationTypes<ContainerType>::SimulationType::Parameters& parameters, const mcchd::coordinate_type& extents,
+			    const bool& cavity_bias, const uint32_t& seed, const std::vector<double>& ladder, const uint32_t& num_threads, const bool& binary_output)
+{
+  typedef typename SimulationTypes<ContainerType>::ConfigurationType ConfigurationType;
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
+
+  const uint32_t num_replicas = ladder.size();
+  std::vector<ConfigurationType*> configurations(num_replicas);
+  std::vector<SimulationType*> replicas(num_replicas);
+  for (uint32_t replica_idx = 0; replica_idx < num_replicas; replica_idx++)
+    {
+      configurations[replica_idx] = new ConfigurationType(extents);
+      configurations[replica_idx]->set_cavity_bias(cavity_bias);
+      replicas[replica_idx] = new SimulationType(parameters, configurations[replica_idx]);
+      replicas[replica_idx]->set_random_seed(mcchd::mix_seed(seed, replica_idx));
+      replicas[replica_idx]->signal_handler_sigterm.connect(handle_sig_term<ContainerType>);
+
+      const std::string measurement_file = output_directory + (boost::format(binary_output ? "/measurements,%d.bin" : "/measurements,%d.out") % replica_idx).str();
+      replica_writers.push_back(new mcchd::MeasurementWriter<energy_type>(measurement_file, binary_output));
+      BOOST_LOG_TRIVIAL(info) << "Replica " << replica_idx << " samples at beta= " << ladder[replica_idx] << ", measurements go to " << measurement_file;
+    }
+
+  RngType swap_rng;
+  swap_rng.set_seed(mcchd::mix_seed(seed, num_replicas));
+  std::vector<uint64_t> swaps_tried(num_replicas, 0);
+  std::vector<uint64_t> swaps_accepted(num_replicas, 0);
+  const mcchd::TemperingSwapProbability swap_probability(ladder);
+
+  BOOST_LOG_TRIVIAL(info) << "Making " << parameters.relaxation_steps << " relaxation steps.";
+  ReplicaSteps<SimulationType> relaxation_steps(replicas, ladder, parameters.relaxation_steps);
+  mcchd::run_on_thread_pool(relaxation_steps, num_replicas, num_threads);
+
+  const std::vector<double> log_percentages = progress_log_percentages();
+  std::vector<double>::const_iterator next_percentage = log_percentages.begin();
+
+  ReplicaSteps<SimulationType> round_steps(replicas, ladder, parameters.steps_between_measurement);
+  for (uint32_t round = 0; round < parameters.measurement_number; round++)
+    {
+      const double percentage = (double)round / (double)parameters.measurement_number;
+      if (percentage >= *next_percentage)
+	{
+	  BOOST_LOG_TRIVIAL(info) << "Simulation is  " << percentage << " finished.";
+	  next_percentage++;
+	}
 
-  append_value_to_file(output_file, current_energy);
+      mcchd::run_on_thread_pool(round_steps, num_replicas, num_threads);
+      for (uint32_t replica_idx = 0; replica_idx < num_replicas; replica_idx++)
+	replica_writers[replica_idx]->append(replicas[replica_idx]->get_config_space()->energy());
+
+      mcchd::swap_neighbours<ConfigurationType>(replicas, round, swap_probability, swap_rng, swaps_tried, swaps_accepted);
+    }
+
+  std::ofstream swap_rates_fstream((output_directory + "/swap_rates.out").c_str());
+  swap_rates_fstream << "# replica\tbeta\tbeta_next\ttried\taccepted\trate" << std::endl;
+  for (uint32_t replica_idx = 0; replica_idx + 1 < num_replicas; replica_idx++)
+    {
+      const double rate = (swaps_tried[replica_idx] > 0) ? (double)swaps_accepted[replica_idx] / (double)swaps_tried[replica_idx] : 0.;
+      swap_rates_fstream << replica_idx << '\t' << ladder[replica_idx] << '\t' << ladder[replica_idx + 1] << '\t' << swaps_tried[replica_idx] << '\t' << swaps_accepted[replica_idx] << '\t' << rate << std::endl;
+      BOOST_LOG_TRIVIAL(info) << "Beta " << ladder[replica_idx] << " and " << ladder[replica_idx + 1] << " swapped " << swaps_accepted[replica_idx] << " of " << swaps_tried[replica_idx] << " times.";
+    }
+
+  for (uint32_t replica_idx = 0; replica_idx < num_replicas; replica_idx++)
+    {
+      replica_writers[replica_idx]->flush();
+      delete replica_writers[replica_idx];
+    }
+  replica_writers.clear();
+  // the configurations may have been swapped, each is deleted once
+  for (uint32_t replica_idx = 0; replica_idx < num_replicas; replica_idx++)
+    {
+      delete replicas[replica_idx];
+      delete configurations[replica_idx];
+    }
 }
 
 // declaration of the main simulation routine -- defined below
-void run_simulation(boost_po::variables_map&, std::string&);
+template <class ContainerType> void run_simulation(boost_po::variables_map&, std::string&);
+
+/// runs the simulation with the container passed by dispatch_container
+struct SimulationRunner
+{
+  boost_po::variables_map& option_arguments;
+  std::string& program_name;
+
+  SimulationRunner(boost_po::variables_map& new_option_arguments, std::string& new_program_name) : option_arguments(new_option_arguments), program_name(new_program_name) {}
+  template <class ContainerType> void run()
+  {
+    run_simulation<ContainerType>(option_arguments, program_name);
+  }
+};
 
 
 int main(int argc, char* argv[])
@@ -148,11 +432,21 @@ int main(int argc, char* argv[])
         ("height,h,y", boost_po::value<double>()->default_value(10.), "Height of the Box - y coordinate.")
         ("depth,d,z", boost_po::value<double>()->default_value(10.), "Depth of the Box - z coordinate.")
         ("seed,S", boost_po::value<uint32_t>()->default_value(1), "Seed of the Random number generator.")
+        ("container,C", boost_po::value<std::string>()->default_value("Bulk"), (std::string("Geometry of the container, one of ") + mcchd::container_names + ".").c_str())
+        ("voxelized,V", "Answer container checks from a precomputed voxel table.")
         ("relaxation_steps,r", boost_po::value<uint32_t>()->default_value(1000), "Number of steps before beginning measurement.")
         ("num_measurements,n", boost_po::value<uint32_t>()->default_value(1000), "How many samples should be taken.")
         ("beta,b", boost_po::value<double>()->default_value(1.0), "Inverse temperature beta.")
         ("output_directory,o", boost_po::value<std::string>(), "Directory for the output of results, progress reports etc.")
         ("steps_between_measurements,N", boost_po::value<uint32_t>()->default_value(100), "How many steps between 2 measurements.")
+        ("cavity_bias,c", "Propose insertions only in cells which can take another disc.")
+        ("binary_output,B", (boost::format("Write the measurements as raw %d bit %s integers in native byte order to measurements.bin instead of text to measurements.out. With chains, each measurement is preceded by its chain index as a 32 bit unsigned integer.")
+			     % (8 * sizeof(energy_type)) % (std::numeric_limits<energy_type>::is_signed ? "signed" : "unsigned")).str().c_str())
+        ("chains,K", boost_po::value<uint32_t>()->default_value(1), "Number of independent chains, each with its own random number stream. The measurements are tagged with the chain index, the averages of all chains go to averages.out.")
+        ("threads,j", boost_po::value<uint32_t>()->default_value(0), "Threads running the chains or replicas, 0 for one per core.")
+        ("replicas,M", boost_po::value<uint32_t>()->default_value(1), "Parallel tempering: number of replicas at equally spaced beta from beta to beta_upper. Neighbours try to swap their configurations after every measurement, the measurements of each beta go to their own file.")
+        ("beta_upper,U", boost_po::value<double>(), "Beta of the last replica.")
+        ("parallel_sweeps,P", boost_po::value<uint32_t>()->default_value(0), "Sweeps of displacement moves over all discs after the steps between two measurements, run on the threads over a checkerboard of domains. For large boxes.")
         ;
       
       boost_po::variables_map option_arguments;
@@ -168,7 +462,9 @@ int main(int argc, char* argv[])
       
       std::string program_name = std::string(argv[0]);
 
-      run_simulation(option_arguments, program_name);
+      // one instantiation of the whole simulation per container
+      SimulationRunner simulation_runner(option_arguments, program_name);
+      mcchd::dispatch_container(option_arguments["container"].as<std::string>(), option_arguments.count("voxelized") > 0, simulation_runner);
     }
   catch (std::exception &exceptionX)
     {
@@ -181,8 +477,12 @@ int main(int argc, char* argv[])
 
 
 
+template <class ContainerType>
 void run_simulation(boost_po::variables_map& option_arguments, std::string& program_name)
 {
+  typedef typename SimulationTypes<ContainerType>::ConfigurationType ConfigurationType;
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
+
   BOOST_LOG_TRIVIAL(debug) << "Entered run_simulation.";
 
   // read options
@@ -190,10 +490,26 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
   const double y_max = option_arguments["height"].as<double>();
   const double z_max = option_arguments["depth"].as<double>();
   const uint32_t seed = option_arguments["seed"].as<uint32_t>();
+  const std::string container_name = option_arguments["container"].as<std::string>();
   const uint32_t relaxation_steps = option_arguments["relaxation_steps"].as<uint32_t>();
   const uint32_t num_measurements = option_arguments["num_measurements"].as<uint32_t>();
   const uint32_t steps_between_measurements = option_arguments["steps_between_measurements"].as<uint32_t>();
   const double beta = option_arguments["beta"].as<double>();
+  const bool binary_output = option_arguments.count("binary_output") > 0;
+  const uint32_t num_chains = option_arguments["chains"].as<uint32_t>();
+  const uint32_t num_threads = option_arguments["threads"].as<uint32_t>();
+  const uint32_t num_replicas = option_arguments["replicas"].as<uint32_t>();
+  const uint32_t parallel_sweeps = option_arguments["parallel_sweeps"].as<uint32_t>();
+
+  if (num_replicas > 1 && (num_chains > 1 || !option_arguments.count("beta_upper") || !(option_arguments["beta_upper"].as<double>() > beta)))
+    {
+      throw tempering_options_exception;
+    }
+
+  if (parallel_sweeps > 0 && (num_chains > 1 || num_replicas > 1))
+    {
+      throw parallel_sweeps_options_exception;
+    }
 
   BOOST_LOG_TRIVIAL(debug) << "Finished reading simulation options.";
 
@@ -205,8 +521,9 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
     }
   else
     {
-      output_directory = (boost::format("%s,x%.1e,y%.1e,z%.1e,S%d,b%.1e,r%.1e,n%.1e,N%.1e")
+      output_directory = (boost::format("%s,%s,x%.1e,y%.1e,z%.1e,S%d,b%.1e,r%.1e,n%.1e,N%.1e")
 			  % program_name.c_str()
+			  % container_name.c_str()
 			  % x_max
 			  % y_max
 			  % z_max
@@ -233,47 +550,47 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
   // create simulation objects
   mcchd::coordinate_type extents = {{x_max, y_max, z_max}};
 
-  SimulationType::Parameters metropolis_parameters;
+  typename SimulationType::Parameters metropolis_parameters;
   metropolis_parameters.relaxation_steps = relaxation_steps;
   metropolis_parameters.measurement_number = num_measurements;
   metropolis_parameters.steps_between_measurement = steps_between_measurements;
 
+  if (num_chains > 1)
+    {
+      run_chains<ContainerType>(metropolis_parameters, extents, option_arguments.count("cavity_bias") > 0, seed, beta, num_chains, num_threads, binary_output);
+      return;
+    }
+
+  if (num_replicas > 1)
+    {
+      run_parallel_tempering<ContainerType>(metropolis_parameters, extents, option_arguments.count("cavity_bias") > 0, seed,
+					    mcchd::beta_ladder(beta, option_arguments["beta_upper"].as<double>(), num_replicas), num_threads, binary_output);
+      return;
+    }
+
   ConfigurationType* hard_sphere_configuration = new ConfigurationType(extents);
+  if (option_arguments.count("cavity_bias"))
+    hard_sphere_configuration->set_cavity_bias(true);
   SimulationType* metropolis_simulation = new SimulationType(metropolis_parameters, hard_sphere_configuration);
 
   metropolis_simulation->set_random_seed(seed);
+  mcchd::CheckerboardSweeps<ConfigurationType, RngType> checkerboard_sweeps(hard_sphere_configuration, seed, num_threads);
+  if (parallel_sweeps > 0)
+    BOOST_LOG_TRIVIAL(info) << "Parallel sweeps over " << checkerboard_sweeps.get_num_blocks()[0] << " x " << checkerboard_sweeps.get_num_blocks()[1] << " x " << checkerboard_sweeps.get_num_blocks()[2]
+			    << " domains on " << checkerboard_sweeps.get_num_threads() << " threads.";
   
   // attach watchers
-  metropolis_simulation->signal_handler_sigusr1.connect(handle_sig_usr1);
-  metropolis_simulation->signal_handler_sigusr2.connect(handle_sig_usr2);
-  metropolis_simulation->signal_handler_sigterm.connect(handle_sig_term);
+  metropolis_simulation->signal_handler_sigusr1.connect(handle_sig_usr1<ContainerType>);
+  metropolis_simulation->signal_handler_sigusr2.connect(handle_sig_usr2<ContainerType>);
+  metropolis_simulation->signal_handler_sigterm.connect(handle_sig_term<ContainerType>);
 
+  const std::string measurement_file = output_directory + (binary_output ? "/measurements.bin" : "/measurements.out");
+  measurement_writer = new mcchd::MeasurementWriter<energy_type>(measurement_file, binary_output);
   
   BOOST_LOG_TRIVIAL(info) << "Making " << relaxation_steps << " relaxation steps.";
   metropolis_simulation->do_metropolis_steps(relaxation_steps, beta);
 
-  std::vector<double> log_percentages;
-  log_percentages.push_back(0.001);
-  log_percentages.push_back(0.002);
-  log_percentages.push_back(0.005);
-  log_percentages.push_back(0.01);
-  log_percentages.push_back(0.015);
-  log_percentages.push_back(0.02);
-  log_percentages.push_back(0.025);
-  log_percentages.push_back(0.05);
-  log_percentages.push_back(0.075);
-  log_percentages.push_back(0.1);
-  log_percentages.push_back(0.15);
-  log_percentages.push_back(0.2);
-  log_percentages.push_back(0.25);
-  log_percentages.push_back(0.3);
-  log_percentages.push_back(0.4);
-  log_percentages.push_back(0.5);
-  log_percentages.push_back(0.6);
-  log_percentages.push_back(0.7);
-  log_percentages.push_back(0.8);
-  log_percentages.push_back(0.9);
-  log_percentages.push_back(1.);
+  const std::vector<double> log_percentages = progress_log_percentages();
 
   std::vector<double>::const_iterator next_percentage = log_percentages.begin();
 
@@ -287,9 +604,14 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
 	}
 
       metropolis_simulation->do_metropolis_steps(steps_between_measurements, beta);
-      measurement_handler(metropolis_simulation);
+      for (uint32_t sweep = 0; sweep < parallel_sweeps; sweep++)
+	checkerboard_sweeps.sweep();
+      measurement_handler<ContainerType>(metropolis_simulation);
     }
 
+  measurement_writer->flush();
+  delete measurement_writer;
+  measurement_writer = 0;
   delete hard_sphere_configuration;
   delete metropolis_simulation;
 }
@@ -0,0 +1,279 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file mcchd_mpi.cpp
+ * \brief Program frontend for grand canonical hard sphere simulations split over MPI ranks
+ *
+ * The box is cut into one slab along x per rank, see DomainDecomposition.hpp.
+ * Between two measurements every rank makes steps_between_measurements
+ * steps in its slab. Rank 0 writes the number of discs in the whole box
+ * and the protocol.
+ *
+ * Start it with e.g.
+ *  mpirun -np 4 mcchd_mpi -x 40
+ * For usage info execute:
+ *  mcchd_mpi --help
+ *
+ * \author Johannes Knauf
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/common.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/attributes.hpp>
+#include <boost/log/sinks.hpp>
+#include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/utility/setup/console.hpp>
+#include <boost/log/utility/setup/file.hpp>
+#include <boost/log/utility/setup/common_attributes.hpp>
+#include <boost/log/sources/severity_logger.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+#include <boost/log/sources/logger.hpp>
+#include <boost/log/support/date_time.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <boost/filesystem.hpp>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <mocasinns/random/boost_random.hpp>
+#include <HardDiscs.hpp>
+#include <LookupTable_Flat.hpp>
+#include <ContainerDispatch.hpp>
+#include <MeasurementWriter.hpp>
+#include <DomainDecomposition.hpp>
+
+namespace boost_po = boost::program_options;
+namespace boost_fs = boost::filesystem;
+
+typedef mcchd::disc_id_type energy_type;
+typedef Mocasinns::Random::Boost_MT19937 RngType;
+
+static std::string output_directory;
+
+/// fractions of the measurements at which the progress is logged
+std::vector<double> progress_log_percentages()
+{
+  std::vector<double> log_percentages;
+  log_percentages.push_back(0.001);
+  log_percentages.push_back(0.01);
+  log_percentages.push_back(0.05);
+  log_percentages.push_back(0.1);
+  log_percentages.push_back(0.2);
+  log_percentages.push_back(0.3);
+  log_percentages.push_back(0.4);
+  log_percentages.push_back(0.5);
+  log_percentages.push_back(0.6);
+  log_percentages.push_back(0.7);
+  log_percentages.push_back(0.8);
+  log_percentages.push_back(0.9);
+  log_percentages.push_back(1.);
+  return log_percentages;
+}
+
+/// only rank 0 logs, the others stay silent
+void init_logging(const boost::mpi::communicator& world)
+{
+  if (world.rank() != 0)
+    {
+      boost::log::core::get()->set_logging_enabled(false);
+      return;
+    }
+
+  boost::log::add_common_attributes();
+  boost::log::add_console_log(std::clog,
+			      boost::log::keywords::format = boost::log::expressions::stream
+			      << boost::log::expressions::format_date_time< boost::posix_time::ptime >("TimeStamp", "%Y-%m-%d %H:%M:%S.%f")
+			      << " [" << boost::log::expressions::attr< unsigned int >("LineID")
+			      << "] <" << boost::log::expressions::attr< boost::log::trivial::severity_level >("Severity")
+			      << "> " << boost::log::expressions::message);
+
+  boost::log::add_file_log (boost::log::keywords::file_name = (output_directory + std::string("/protocol.log")).c_str(),
+			    boost::log::keywords::auto_flush = true,
+			    boost::log::keywords::format = boost::log::expressions::stream
+			    << boost::log::expressions::format_date_time< boost::posix_time::ptime >("TimeStamp", "%Y-%m-%d %H:%M:%S.%f")
+			    << " [" << boost::log::expressions::attr< unsigned int >("LineID")
+			    << "] <" << boost::log::expressions::attr< boost::log::trivial::severity_level >("Severity")
+			    << "> " << boost::log::expressions::message);
+
+  boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
+  BOOST_LOG_TRIVIAL(info) << "Logging facilities successfully initialized.";
+}
+
+// declaration of the main simulation routine -- defined below
+template <class ContainerType> void run_simulation(boost_po::variables_map&, boost::mpi::communicator&);
+
+/// runs the simulation with the container passed by dispatch_container
+struct SimulationRunner
+{
+  boost_po::variables_map& option_arguments;
+  boost::mpi::communicator& world;
+
+  SimulationRunner(boost_po::variables_map& new_option_arguments, boost::mpi::communicator& new_world) : option_arguments(new_option_arguments), world(new_world) {}
+  template <class ContainerType> void run()
+  {
+    run_simulation<ContainerType>(option_arguments, world);
+  }
+};
+
+
+int main(int argc, char* argv[])
+{
+  boost::mpi::environment environment(argc, argv);
+  boost::mpi::communicator world;
+
+  try
+    {
+      boost_po::options_description option_desc("Available options");
+      option_desc.add_options()
+        ("help,h", "Prints this message.")
+        ("width,w,x", boost_po::value<double>()->default_value(20.), "Width of the Box - x coordinate, cut into the slabs of the ranks.")
+        ("height,h,y", boost_po::value<double>()->default_value(10.), "Height of the Box - y coordinate.")
+        ("depth,d,z", boost_po::value<double>()->default_value(10.), "Depth of the Box - z coordinate.")
+        ("seed,S", boost_po::value<uint32_t>()->default_value(1), "Seed of the Random number generators, each rank derives its own.")
+        ("container,C", boost_po::value<std::string>()->default_value("Bulk"), (std::string("Geometry of the container, one of ") + mcchd::container_names + ".").c_str())
+        ("voxelized,V", "Answer container checks from a precomputed voxel table.")
+        ("relaxation_steps,r", boost_po::value<uint32_t>()->default_value(1000), "Number of steps of each rank before beginning measurement.")
+        ("num_measurements,n", boost_po::value<uint32_t>()->default_value(1000), "How many samples should be taken.")
+        ("beta,b", boost_po::value<double>()->default_value(1.0), "Inverse temperature beta.")
+        ("output_directory,o", boost_po::value<std::string>(), "Directory for the output of results, progress reports etc.")
+        ("steps_between_measurements,N", boost_po::value<uint32_t>()->default_value(100), "How many steps of each rank between 2 measurements.")
+        ("binary_output,B", (boost::format("Write the measurements as raw %d bit %s integers in native byte order to measurements.bin instead of text to measurements.out.")
+			     % (8 * sizeof(energy_type)) % (std::numeric_limits<energy_type>::is_signed ? "signed" : "unsigned")).str().c_str())
+        ;
+
+      boost_po::variables_map option_arguments;
+      boost_po::store (boost_po::parse_command_line (argc, argv, option_desc), option_arguments);
+      boost_po::notify (option_arguments);
+
+      if (option_arguments.count("help"))
+        {
+	  if (world.rank() == 0)
+	    {
+	      std::cerr << "Usage: mpirun -np <ranks> mcchd_mpi [options]" << std::endl;
+	      std::cerr << option_desc;
+	    }
+          return 0;
+        }
+
+      // rank 0 picks the output directory, the others need its name only for the protocol
+      if (world.rank() == 0)
+	{
+	  if (option_arguments.count("output_directory"))
+	    {
+	      output_directory = option_arguments["output_directory"].as<std::string>();
+	    }
+	  else
+	    {
+	      output_directory = (boost::format("%s,%s,P%d,x%.1e,y%.1e,z%.1e,S%d,b%.1e,r%.1e,n%.1e,N%.1e")
+				  % argv[0]
+				  % option_arguments["container"].as<std::string>().c_str()
+				  % world.size()
+				  % option_arguments["width"].as<double>()
+				  % option_arguments["height"].as<double>()
+				  % option_arguments["depth"].as<double>()
+				  % option_arguments["seed"].as<uint32_t>()
+				  % option_arguments["beta"].as<double>()
+				  % option_arguments["relaxation_steps"].as<uint32_t>()
+				  % option_arguments["num_measurements"].as<uint32_t>()
+				  % option_arguments["steps_between_measurements"].as<uint32_t>()).str();
+	    }
+	  boost::format output_directory_formatter(output_directory + "_%d");
+	  uint64_t trial_number = 0;
+	  output_directory = (output_directory_formatter % trial_number).str();
+	  while(boost_fs::exists(output_directory.c_str()))
+	    {
+	      trial_number += 1;
+	      output_directory = (output_directory_formatter % trial_number).str();
+	    }
+	  boost_fs::create_directory(output_directory.c_str());
+	}
+      boost::mpi::broadcast(world, output_directory, 0);
+
+      init_logging(world);
+
+      // one instantiation of the whole simulation per container
+      SimulationRunner simulation_runner(option_arguments, world);
+      mcchd::dispatch_container(option_arguments["container"].as<std::string>(), option_arguments.count("voxelized") > 0, simulation_runner);
+    }
+  catch (std::exception &exceptionX)
+    {
+      // the options and slabs are the same on all ranks, so all of them end up here
+      if (world.rank() == 0)
+	std::cout << exceptionX.what() << std::endl;
+      return 1;
+    }
+
+  return 0;
+}
+
+
+
+template <class ContainerType>
+void run_simulation(boost_po::variables_map& option_arguments, boost::mpi::communicator& world)
+{
+  typedef mcchd::HardDiscs<ContainerType, mcchd::LookupTable_Flat> ConfigurationType;
+
+  // read options
+  const double x_max = option_arguments["width"].as<double>();
+  const double y_max = option_arguments["height"].as<double>();
+  const double z_max = option_arguments["depth"].as<double>();
+  const uint32_t seed = option_arguments["seed"].as<uint32_t>();
+  const uint32_t relaxation_steps = option_arguments["relaxation_steps"].as<uint32_t>();
+  const uint32_t num_measurements = option_arguments["num_measurements"].as<uint32_t>();
+  const uint32_t steps_between_measurements = option_arguments["steps_between_measurements"].as<uint32_t>();
+  const double beta = option_arguments["beta"].as<double>();
+  const bool binary_output = option_arguments.count("binary_output") > 0;
+
+  // create simulation objects
+  mcchd::coordinate_type extents = {{x_max, y_max, z_max}};
+  ConfigurationType hard_sphere_configuration(extents);
+  mcchd::DomainDecomposition<ConfigurationType, RngType> decomposition(world, &hard_sphere_configuration, seed);
+  BOOST_LOG_TRIVIAL(info) << "Split the box into " << decomposition.get_num_ranks() << " slabs of width " << x_max / decomposition.get_num_ranks() << " along x.";
+
+  mcchd::MeasurementWriter<energy_type>* measurement_writer = 0;
+  if (world.rank() == 0)
+    measurement_writer = new mcchd::MeasurementWriter<energy_type>(output_directory + (binary_output ? "/measurements.bin" : "/measurements.out"), binary_output);
+
+  // the relaxation is made of sweeps as long as the ones between measurements
+  BOOST_LOG_TRIVIAL(info) << "Making " << relaxation_steps << " relaxation steps on each rank.";
+  const uint32_t relaxation_sweep_steps = std::max<uint32_t>(steps_between_measurements, 1);
+  for (uint32_t relaxed_steps = 0; relaxed_steps < relaxation_steps; relaxed_steps += relaxation_sweep_steps)
+    decomposition.sweep(beta, std::min(relaxation_sweep_steps, relaxation_steps - relaxed_steps));
+
+  const std::vector<double> log_percentages = progress_log_percentages();
+  std::vector<double>::const_iterator next_percentage = log_percentages.begin();
+
+  for (uint32_t i = 0; i < num_measurements; i++)
+    {
+      const double percentage = (double)i / (double)num_measurements;
+      if (percentage >= *next_percentage)
+	{
+	  BOOST_LOG_TRIVIAL(info) << "Simulation is  " << percentage << " finished.";
+	  next_percentage++;
+	}
+
+      decomposition.sweep(beta, steps_between_measurements);
+      const energy_type num_discs = decomposition.get_number_of_discs();
+      if (measurement_writer)
+	measurement_writer->append(num_discs);
+    }
+
+  if (measurement_writer)
+    {
+      measurement_writer->flush();
+      delete measurement_writer;
+    }
+  BOOST_LOG_TRIVIAL(info) << "Simulation finished.";
+}
@@ -14,7 +14,15 @@
 #include <iomanip>
 #include <fstream>
 #include <limits>
+#include <vector>
+#include <thread>
 #include <cstdlib>
+#include <cmath>
+#include <csignal>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include <boost/log/trivial.hpp>
 #include <boost/log/core.hpp>
@@ -42,9 +50,14 @@
 
 #include <mcchd_typedefs.hpp>
 #include <HardDiscs.hpp>
-#include <CollisionFunctor_SingularDefects.hpp>
-#include <CollisionFunctor_NodalSurfaces.hpp>
-#include <CollisionFunctor_SimpleGeometries.hpp>
+#include <LookupTable_Flat.hpp>
+#include <ContainerDispatch.hpp>
+#include <SeedMixing.hpp>
+#include <Checkpoint.hpp>
+#include <ReplicaExchange.hpp>
+#include <NeighbourSwaps.hpp>
+#include <MultipleWalkers.hpp>
+#include <TransitionMatrix.hpp>
 
 namespace boost_po = boost::program_options;
 namespace boost_fs = boost::filesystem;
@@ -53,27 +66,23 @@ namespace boost_fs = boost::filesystem;
 #define __MCCHD_VERSION "_unspecified version_"
 #endif
 
-#ifndef CONTAINER_NAME
-#define CONTAINER_NAME Bulk
-#endif
-
-// double layering of definitions is necessary because of c preprocessor replacement rules
-#define PASTER(x,y) x ## _ ## y
-#define EVALUATOR(x,y) PASTER(x,y)
-#define CONTAINER_TYPE EVALUATOR(mcchd::CF, CONTAINER_NAME)
-
-
 typedef uint64_t signal_flag_t;
 typedef mcchd::energy_type energy_type;
 typedef Mocasinns::Random::Boost_MT19937 RngType;
-typedef CONTAINER_TYPE ContainerType;
 typedef Mocasinns::Histograms::Histocrete<energy_type, long unsigned int> IncidenceHistogramType;
 typedef Mocasinns::Histograms::Histocrete<energy_type, double> HistogramType;
-typedef mcchd::HardDiscs<ContainerType> ConfigurationType;
-typedef mcchd::Step<ConfigurationType> StepType;
-typedef Mocasinns::Simulation<ConfigurationType, RngType> ParentSimulationType;
-typedef Mocasinns::Metropolis<ConfigurationType, StepType, RngType> PreparationSimulationType;
-typedef Mocasinns::WangLandau<ConfigurationType, StepType, energy_type, Mocasinns::Histograms::Histocrete, RngType> SimulationType;
+
+/// simulation types for one container, which is chosen at runtime with --container
+template <class ContainerType>
+struct SimulationTypes
+{
+  typedef mcchd::HardDiscs<ContainerType, mcchd::LookupTable_Flat> ConfigurationType;
+  typedef mcchd::Step<ConfigurationType> StepType;
+  typedef Mocasinns::Simulation<ConfigurationType, RngType> ParentSimulationType;
+  typedef Mocasinns::Metropolis<ConfigurationType, StepType, RngType> PreparationSimulationType;
+  typedef Mocasinns::WangLandau<ConfigurationType, StepType, energy_type, Mocasinns::Histograms::Histocrete, RngType> SimulationType;
+  typedef mcchd::Checkpoint<ConfigurationType, HistogramType, IncidenceHistogramType> CheckpointType;
+};
 
 class EnergyCutoffConflictException: public std::exception
 {
@@ -83,8 +92,96 @@ class EnergyCutoffConflictException: public std::exception
   }
 } energy_cutoff_conflict_exception;
 
+class ReplicaExchangeOptionsException: public std::exception
+{
+  virtual const char* what() const throw()
+  {
+    return "Replica exchange needs E_max, and takes neither checkpoints, nor a restart, nor an initial log DOS file.";
+  }
+} replica_exchange_options_exception;
+
+class MultipleWalkersOptionsException: public std::exception
+{
+  virtual const char* what() const throw()
+  {
+    return "Multiple walkers cannot be combined with windows, and take neither checkpoints nor a restart.";
+  }
+} multiple_walkers_options_exception;
+
+class ScheduleOptionsException: public std::exception
+{
+  virtual const char* what() const throw()
+  {
+    return "Unknown schedule, or the inverse_time schedule combined with windows or multiple walkers.";
+  }
+} schedule_options_exception;
+
+class TmmcOptionsException: public std::exception
+{
+  virtual const char* what() const throw()
+  {
+    return "The transition matrix is only collected by a single walker without windows, and is not restarted from a checkpoint.";
+  }
+} tmmc_options_exception;
+
 static std::string output_directory;
 
+/// checkpointing state, shared with the signal handlers
+struct CheckpointSchedule
+{
+  uint32_t seed;
+  double flatness;
+  double interval; /// seconds between two checkpoints, 0 for checkpoints on SIGTERM only
+  time_t last_time;
+  uint64_t sweep_count;
+  pid_t writer_pid; /// forked process writing the last checkpoint, 0 if none is running
+};
+static CheckpointSchedule checkpoint_schedule;
+
+/// modification factor schedule, applied by the sweep handler
+/// The 1/t schedule of Belardinelli and Pereyra refines geometrically until the modification factor falls to N_E/t,
+/// with N_E the number of sampled energies and t the number of proposed steps, and follows N_E/t from then on.
+struct ModificationSchedule
+{
+  bool inverse_time;
+  bool inverse_time_phase; /// modification factor follows N_E/t
+  double sweep_steps;
+};
+static ModificationSchedule modification_schedule;
+
+/// transition matrix collected alongside the Wang Landau steps, 0 if switched off
+static mcchd::TransitionMatrix* transition_matrix = 0;
+/// the transition matrix entropy replaces the Wang Landau one at every modification factor change
+static bool tmmc_feedback = false;
+
+/// set by the POSIX handlers installed in place of those of Mocasinns, acted on between two sweeps
+static volatile sig_atomic_t termination_signal = 0;
+static volatile sig_atomic_t snapshot_signal = 0;
+
+void note_sig_term(int)
+{
+  termination_signal = 1;
+}
+
+void note_sig_usr1(int)
+{
+  snapshot_signal = 1;
+}
+
+/// the threaded runs sweep their walkers themselves, so SIGTERM and SIGUSR1 are taken from Mocasinns
+/// Called after constructing the walkers, whose constructors install the handlers of Mocasinns.
+void install_sweep_signal_handlers()
+{
+  std::signal(SIGTERM, note_sig_term);
+  std::signal(SIGUSR1, note_sig_usr1);
+}
+
+/// N_E/t after sweep_count sweeps
+double inverse_time_modification_factor(const std::size_t& num_energies, const uint64_t& sweep_count)
+{
+  return num_energies / (sweep_count * modification_schedule.sweep_steps);
+}
+
 void init_logging()
 {
   boost::log::add_common_attributes();
@@ -134,8 +231,10 @@ void write_dos_to_file(std::string output_filename, HistogramType& entropy_estim
     }
 }
 
-void handle_sig_usr1(ParentSimulationType* parent_simulation)
+template <class ContainerType>
+void handle_sig_usr1(typename SimulationTypes<ContainerType>::ParentSimulationType* parent_simulation)
 {
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
   BOOST_LOG_TRIVIAL(debug) << "Caught SIGUSR1. Writing a snapshot of the entropy estimation";
   SimulationType* wang_landau_simulation = static_cast<SimulationType*> (parent_simulation);
   HistogramType entropy_estimation = wang_landau_simulation->get_log_density_of_states();
@@ -149,8 +248,10 @@ void handle_sig_usr1(ParentSimulationType* parent_simulation)
   write_dos_to_file(output_file, entropy_estimation);
 }
 
-void handle_sig_usr2(ParentSimulationType* parent_simulation)
+template <class ContainerType>
+void handle_sig_usr2(typename SimulationTypes<ContainerType>::ParentSimulationType* parent_simulation)
 {
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
   BOOST_LOG_TRIVIAL(debug) << "Caught SIGUSR2. Manually clearing flatness counter.";
   SimulationType* wang_landau_simulation = static_cast<SimulationType*> (parent_simulation);
   IncidenceHistogramType incidence_counter = wang_landau_simulation->get_incidence_counter();
@@ -159,25 +260,125 @@ void handle_sig_usr2(ParentSimulationType* parent_simulation)
   wang_landau_simulation->set_incidence_counter(incidence_counter);
 }
 
-void handle_sig_term(ParentSimulationType* parent_simulation)
+/// collects the checkpoint writer, if it has finished or if wait is set, returns whether one is still running
+bool reap_checkpoint_writer(const bool& wait)
 {
-  BOOST_LOG_TRIVIAL(debug) << "Caught SIGTERM.";
-  BOOST_LOG_TRIVIAL(debug) << "No special handling for SIGTERM yet. Calling SIGUSR1 handler for writing a snapshot before exiting.";
-  handle_sig_usr1(parent_simulation);
-  exit(2);
+  if (checkpoint_schedule.writer_pid == 0)
+    return false;
+
+  int status;
+  const pid_t reaped_pid = waitpid(checkpoint_schedule.writer_pid, &status, wait ? 0 : WNOHANG);
+  if (reaped_pid == 0)
+    return true;
+
+  if (reaped_pid == checkpoint_schedule.writer_pid && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+    BOOST_LOG_TRIVIAL(info) << "Checkpoint writer " << checkpoint_schedule.writer_pid << " finished.";
+  else
+    BOOST_LOG_TRIVIAL(error) << "Checkpoint writer " << checkpoint_schedule.writer_pid << " failed, the previous checkpoint is kept.";
+  checkpoint_schedule.writer_pid = 0;
+  return false;
 }
 
-void sweep_handler(ParentSimulationType* parent_simulation)
+/// writes the checkpoint and continues with its resume seed, so a restart from it takes the same path
+/// In the background, a forked copy of the process writes the checkpoint from its copy-on-write view
+/// of the configuration, while the simulation goes on. If fork fails, the checkpoint is written here.
+template <class ContainerType>
+void write_checkpoint(typename SimulationTypes<ContainerType>::SimulationType* wang_landau_simulation, const bool& in_background)
 {
+  typename SimulationTypes<ContainerType>::CheckpointType checkpoint(wang_landau_simulation->get_config_space());
+  checkpoint.log_density_of_states = wang_landau_simulation->get_log_density_of_states();
+  checkpoint.incidence_counter = wang_landau_simulation->get_incidence_counter();
+  checkpoint.modification_factor = wang_landau_simulation->get_modification_factor_current();
+  checkpoint.sweep_count = checkpoint_schedule.sweep_count;
+  checkpoint.resume_seed = mcchd::mix_seed(checkpoint_schedule.seed, checkpoint_schedule.sweep_count);
+
+  const std::string output_file = output_directory + "/checkpoint";
+  const pid_t writer_pid = in_background ? fork() : -1;
+  if (writer_pid == 0)
+    {
+      // the writer only reports through its exit status, and leaves the buffers of the simulation alone
+      try
+	{
+	  checkpoint.save(output_file);
+	}
+      catch (std::exception&)
+	{
+	  _exit(1);
+	}
+      _exit(0);
+    }
+  else if (writer_pid > 0)
+    {
+      checkpoint_schedule.writer_pid = writer_pid;
+      BOOST_LOG_TRIVIAL(info) << "Writing checkpoint after sweep " << checkpoint_schedule.sweep_count << " to " << output_file << " in process " << writer_pid;
+    }
+  else
+    {
+      checkpoint.save(output_file);
+      BOOST_LOG_TRIVIAL(info) << "Wrote checkpoint after sweep " << checkpoint_schedule.sweep_count << " to " << output_file;
+    }
+  wang_landau_simulation->set_random_seed(checkpoint.resume_seed);
+  checkpoint_schedule.last_time = time(NULL);
+}
+
+template <class ContainerType>
+void sweep_handler(typename SimulationTypes<ContainerType>::ParentSimulationType* parent_simulation)
+{
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
   SimulationType* wang_landau_simulation = static_cast<SimulationType*> (parent_simulation);
+  const double current_flatness = wang_landau_simulation->get_incidence_counter().flatness();
+  checkpoint_schedule.sweep_count += 1;
+
+  if (!modification_schedule.inverse_time)
+    BOOST_LOG_TRIVIAL(info) << "Sweep completed with \tt= " << wang_landau_simulation->get_config_space()->get_simulation_time() 
+			    << " \tm= " << wang_landau_simulation->get_modification_factor_current()
+			    << " \tf= " << current_flatness;
+  else
+    {
+      const double inverse_time = inverse_time_modification_factor(wang_landau_simulation->get_log_density_of_states().size(), checkpoint_schedule.sweep_count);
+      BOOST_LOG_TRIVIAL(info) << "Sweep completed with \tt= " << wang_landau_simulation->get_config_space()->get_simulation_time() 
+			      << " \tm= " << wang_landau_simulation->get_modification_factor_current()
+			      << " \tf= " << current_flatness
+			      << " \tN_E/t= " << inverse_time;
+      if (!modification_schedule.inverse_time_phase && wang_landau_simulation->get_modification_factor_current() <= inverse_time)
+	{
+	  modification_schedule.inverse_time_phase = true;
+	  BOOST_LOG_TRIVIAL(info) << "Modification factor reached N_E/t, following the 1/t schedule from now on.";
+	}
+      if (modification_schedule.inverse_time_phase)
+	{
+	  // the histogram never gets flat, so the Wang Landau class leaves the factor alone and ends the run once N_E/t <= mod_final
+	  wang_landau_simulation->set_modification_factor_current(inverse_time);
+	  IncidenceHistogramType incidence_counter = wang_landau_simulation->get_incidence_counter();
+	  incidence_counter.set_all_y_values(0);
+	  wang_landau_simulation->set_incidence_counter(incidence_counter);
+	}
+    }
+
+  // a flat histogram is about to change the modification factor, which a restart could not repeat -- wait for the next sweep
+  if (!modification_schedule.inverse_time_phase && current_flatness >= checkpoint_schedule.flatness)
+    return;
+
+  if (termination_signal)
+    {
+      BOOST_LOG_TRIVIAL(info) << "Caught SIGTERM. Writing a snapshot and a checkpoint after sweep " << checkpoint_schedule.sweep_count << " and exiting.";
+      handle_sig_usr1<ContainerType>(parent_simulation);
+      // the last checkpoint has to be complete before exiting, and nothing may overwrite it afterwards
+      reap_checkpoint_writer(true);
+      write_checkpoint<ContainerType>(wang_landau_simulation, false);
+      exit(2);
+    }
 
-  BOOST_LOG_TRIVIAL(info) << "Sweep completed with \tt= " << wang_landau_simulation->get_config_space()->get_simulation_time() 
-			  << " \tm= " << wang_landau_simulation->get_modification_factor_current()
-			  << " \tf= " << wang_landau_simulation->get_incidence_counter().flatness();
+  // a writer still busy with the previous checkpoint postpones the next one
+  const bool writer_running = reap_checkpoint_writer(false);
+  if (!writer_running && checkpoint_schedule.interval > 0. && difftime(time(NULL), checkpoint_schedule.last_time) >= checkpoint_schedule.interval)
+    write_checkpoint<ContainerType>(wang_landau_simulation, true);
 }
 
-void modfac_handler(ParentSimulationType* parent_simulation)
+template <class ContainerType>
+void modfac_handler(typename SimulationTypes<ContainerType>::ParentSimulationType* parent_simulation)
 {
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
   SimulationType* wang_landau_simulation = static_cast<SimulationType*> (parent_simulation);
   const double current_modification_factor = wang_landau_simulation->get_modification_factor_current();
   HistogramType log_density_of_states = wang_landau_simulation->get_log_density_of_states();
@@ -191,10 +392,303 @@ void modfac_handler(ParentSimulationType* parent_simulation)
   std::string output_file = output_directory + "/modfac_entropy_dump," + world_time + ",mod=" + (boost::format("%e") % current_modification_factor).str();
 
   write_dos_to_file(output_file, log_density_of_states);
+
+  if (transition_matrix)
+    {
+      HistogramType tmmc_log_density_of_states;
+      transition_matrix->fill_log_density_of_states(tmmc_log_density_of_states);
+      tmmc_log_density_of_states.shift_bin_zero(tmmc_log_density_of_states.min_x_value());
+      write_dos_to_file(output_directory + "/tmmc_entropy_dump," + world_time + ",mod=" + (boost::format("%e") % current_modification_factor).str(), tmmc_log_density_of_states);
+
+      if (tmmc_feedback)
+	{
+	  // energies the transition matrix does not connect keep their Wang Landau entropy
+	  HistogramType reference_log_density_of_states = wang_landau_simulation->get_log_density_of_states();
+	  transition_matrix->fill_log_density_of_states(reference_log_density_of_states);
+	  wang_landau_simulation->set_log_density_of_states(reference_log_density_of_states);
+	  BOOST_LOG_TRIVIAL(info) << "Replaced the Wang Landau entropy by the transition matrix estimate.";
+	}
+    }
+}
+
+/// writes the normalized entropy of every window to <prefix><window index>
+template <class SimulationType>
+void write_window_entropies(const std::vector<SimulationType*>& walkers, const std::string& prefix)
+{
+  for (std::size_t window_idx = 0; window_idx < walkers.size(); window_idx++)
+    {
+      HistogramType normalized_log_dos = walkers[window_idx]->get_log_density_of_states();
+      normalized_log_dos.shift_bin_zero(normalized_log_dos.min_x_value());
+      write_dos_to_file(prefix + (boost::format("%d") % window_idx).str(), normalized_log_dos);
+    }
+}
+
+/// one sweep of one walker, run on its own thread
+template <class SimulationType>
+struct WalkerSweep
+{
+  SimulationType* walker;
+  uint32_t sweep_steps;
+
+  WalkerSweep(SimulationType* new_walker, const uint32_t& new_sweep_steps) : walker(new_walker), sweep_steps(new_sweep_steps) {}
+  void operator()()
+  {
+    walker->do_wang_landau_steps(sweep_steps);
+  }
+};
+
+/// exchange probability of the walkers of neighbouring windows, for swap_neighbours
+template <class SimulationType>
+struct WindowExchangeProbability
+{
+  const std::vector<SimulationType*>& walkers;
+  const std::vector<mcchd::EnergyWindow>& windows;
+
+  WindowExchangeProbability(const std::vector<SimulationType*>& new_walkers, const std::vector<mcchd::EnergyWindow>& new_windows) : walkers(new_walkers), windows(new_windows) {}
+  template <class ConfigurationType> double operator()(const std::size_t& lower_idx, const ConfigurationType& lower_configuration, const ConfigurationType& upper_configuration) const
+  {
+    const energy_type lower_energy = lower_configuration.energy();
+    const energy_type upper_energy = upper_configuration.energy();
+
+    // both configurations have to fit into the other window
+    if (lower_energy < windows[lower_idx + 1].lower || lower_energy > windows[lower_idx + 1].upper
+	|| upper_energy < windows[lower_idx].lower || upper_energy > windows[lower_idx].upper)
+      return -std::numeric_limits<double>::infinity();
+
+    return mcchd::exchange_log_probability(walkers[lower_idx]->get_log_density_of_states(), walkers[lower_idx + 1]->get_log_density_of_states(),
+					   lower_energy, upper_energy);
+  }
+};
+
+/// replica exchange Wang Landau: one walker per window, all sweep in parallel, then neighbours may swap configurations
+/// The run ends when every window has reached the final modification factor, its entropy is stitched from all windows.
+/// SIGUSR1 writes a snapshot of the window entropies after the running round, SIGTERM writes them and exits.
+template <class ContainerType>
+void run_replica_exchange(const typename SimulationTypes<ContainerType>::SimulationType::Parameters& base_parameters, const mcchd::coordinate_type& extents,
+			  const bool& cavity_bias, const uint32_t& seed, const std::vector<mcchd::EnergyWindow>& windows)
+{
+  typedef typename SimulationTypes<ContainerType>::ConfigurationType ConfigurationType;
+  typedef typename SimulationTypes<ContainerType>::PreparationSimulationType PreparationSimulationType;
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
+
+  const std::size_t num_windows = windows.size();
+  std::vector<ConfigurationType*> configurations(num_windows);
+  std::vector<SimulationType*> walkers(num_windows);
+  for (std::size_t window_idx = 0; window_idx < num_windows; window_idx++)
+    {
+      typename SimulationType::Parameters window_parameters = base_parameters;
+      window_parameters.use_energy_cutoff_lower = true;
+      window_parameters.energy_cutoff_lower = windows[window_idx].lower;
+      window_parameters.use_energy_cutoff_upper = true;
+      window_parameters.energy_cutoff_upper = windows[window_idx].upper;
+
+      configurations[window_idx] = new ConfigurationType(extents);
+      configurations[window_idx]->set_cavity_bias(cavity_bias);
+
+      // fill up into the window, as for the lower energy cutoff of a single walker
+      typename PreparationSimulationType::Parameters preparation_metropolis_parameters;
+      PreparationSimulationType preparation_metropolis_simulation(preparation_metropolis_parameters, configurations[window_idx]);
+      preparation_metropolis_simulation.set_random_seed(mcchd::mix_seed(seed, window_idx));
+      while (configurations[window_idx]->energy() <= windows[window_idx].lower)
+	preparation_metropolis_simulation.do_metropolis_steps(1, -1000.);
+
+      walkers[window_idx] = new SimulationType(window_parameters, configurations[window_idx]);
+      walkers[window_idx]->set_random_seed(mcchd::mix_seed(seed, window_idx));
+      BOOST_LOG_TRIVIAL(info) << "Window " << window_idx << " covers E= " << windows[window_idx].lower << " .. " << windows[window_idx].upper;
+    }
+
+  RngType exchange_rng;
+  exchange_rng.set_seed(mcchd::mix_seed(seed, num_windows));
+  std::vector<uint64_t> exchanges_tried(num_windows, 0);
+  std::vector<uint64_t> exchanges_accepted(num_windows, 0);
+  const WindowExchangeProbability<SimulationType> exchange_probability(walkers, windows);
+  install_sweep_signal_handlers();
+
+  for (uint64_t round = 0; ; round++)
+    {
+      bool all_converged = true;
+      for (std::size_t window_idx = 0; window_idx < num_windows; window_idx++)
+	all_converged = all_converged && (walkers[window_idx]->get_modification_factor_current() <= base_parameters.modification_factor_final);
+      if (all_converged)
+	break;
+
+      std::vector<std::thread> walker_threads;
+      for (std::size_t window_idx = 0; window_idx < num_windows; window_idx++)
+	walker_threads.push_back(std::thread(WalkerSweep<SimulationType>(walkers[window_idx], base_parameters.sweep_steps)));
+      for (std::size_t window_idx = 0; window_idx < num_windows; window_idx++)
+	walker_threads[window_idx].join();
+
+      // every window refines its own modification factor
+      for (std::size_t window_idx = 0; window_idx < num_windows; window_idx++)
+	{
+	  IncidenceHistogramType incidence_counter = walkers[window_idx]->get_incidence_counter();
+	  if (incidence_counter.flatness() < base_parameters.flatness)
+	    continue;
+	  const double modification_factor = walkers[window_idx]->get_modification_factor_current() * base_parameters.modification_factor_multiplier;
+	  walkers[window_idx]->set_modification_factor_current(modification_factor);
+	  incidence_counter.set_all_y_values(0);
+	  walkers[window_idx]->set_incidence_counter(incidence_counter);
+	  BOOST_LOG_TRIVIAL(info) << "Window " << window_idx << " is flat after round " << round << ", \tm= " << modification_factor;
+	}
+
+      if (snapshot_signal || termination_signal)
+	{
+	  snapshot_signal = 0;
+	  const time_t current_time = time (NULL);
+	  char world_time[16];
+	  strftime (world_time, 16, "%Y%m%d-%H%M%S", gmtime(&current_time));
+	  write_window_entropies(walkers, output_directory + "/intermediate_entropy," + world_time + ",window=");
+	}
+      if (termination_signal)
+	{
+	  BOOST_LOG_TRIVIAL(info) << "Caught SIGTERM. Exiting after round " << round << ".";
+	  exit(2);
+	}
+
+      mcchd::swap_neighbours<ConfigurationType>(walkers, round, exchange_probability, exchange_rng, exchanges_tried, exchanges_accepted);
+    }
+
+  std::vector<HistogramType> window_log_dos(num_windows);
+  for (std::size_t window_idx = 0; window_idx < num_windows; window_idx++)
+    {
+      window_log_dos[window_idx] = walkers[window_idx]->get_log_density_of_states();
+      if (window_idx + 1 < num_windows)
+	BOOST_LOG_TRIVIAL(info) << "Windows " << window_idx << " and " << window_idx + 1 << " exchanged " << exchanges_accepted[window_idx] << " of " << exchanges_tried[window_idx] << " times.";
+    }
+  write_window_entropies(walkers, output_directory + "/window_entropy,");
+
+  HistogramType log_density_of_states = mcchd::stitch_log_dos(window_log_dos, windows);
+  log_density_of_states.shift_bin_zero(log_density_of_states.min_x_value());
+  write_dos_to_file(output_directory + "/final_entropy", log_density_of_states);
+
+  for (std::size_t window_idx = 0; window_idx < num_windows; window_idx++)
+    {
+      delete walkers[window_idx];
+      delete configurations[window_idx];
+    }
+}
+
+/// several walkers in the same energy range with one shared entropy estimate, each walker sweeps on its own thread
+/// After every sweep the changes of all walkers are merged into the shared histograms, flatness is checked and the
+/// modification factor refined once for all, then every walker continues from the shared state.
+/// SIGUSR1 writes a snapshot of the shared entropy after the running sweep, SIGTERM writes it and exits.
+template <class ContainerType>
+void run_multiple_walkers(const typename SimulationTypes<ContainerType>::SimulationType::Parameters& parameters, const mcchd::coordinate_type& extents,
+			  const bool& cavity_bias, const uint32_t& seed, const uint32_t& num_walkers, const HistogramType* initial_log_dos)
+{
+  typedef typename SimulationTypes<ContainerType>::ConfigurationType ConfigurationType;
+  typedef typename SimulationTypes<ContainerType>::PreparationSimulationType PreparationSimulationType;
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
+
+  std::vector<ConfigurationType*> configurations(num_walkers);
+  std::vector<SimulationType*> walkers(num_walkers);
+  for (uint32_t walker_idx = 0; walker_idx < num_walkers; walker_idx++)
+    {
+      configurations[walker_idx] = new ConfigurationType(extents);
+      configurations[walker_idx]->set_cavity_bias(cavity_bias);
+
+      if (parameters.use_energy_cutoff_lower)
+	{
+	  typename PreparationSimulationType::Parameters preparation_metropolis_parameters;
+	  PreparationSimulationType preparation_metropolis_simulation(preparation_metropolis_parameters, configurations[walker_idx]);
+	  preparation_metropolis_simulation.set_random_seed(mcchd::mix_seed(seed, walker_idx));
+	  while (configurations[walker_idx]->energy() <= parameters.energy_cutoff_lower)
+	    preparation_metropolis_simulation.do_metropolis_steps(1, -1000.);
+	}
+
+      walkers[walker_idx] = new SimulationType(parameters, configurations[walker_idx]);
+      walkers[walker_idx]->set_random_seed(mcchd::mix_seed(seed, walker_idx));
+      if (initial_log_dos)
+	walkers[walker_idx]->set_log_density_of_states(*initial_log_dos);
+    }
+
+  HistogramType shared_log_dos = walkers[0]->get_log_density_of_states();
+  IncidenceHistogramType shared_incidence_counter = walkers[0]->get_incidence_counter();
+  double modification_factor = parameters.modification_factor_initial;
+  std::vector<HistogramType> walker_log_dos(num_walkers);
+  std::vector<IncidenceHistogramType> walker_incidence_counters(num_walkers);
+  install_sweep_signal_handlers();
+
+  for (uint64_t sweep = 0; modification_factor > parameters.modification_factor_final; sweep++)
+    {
+      std::vector<std::thread> walker_threads;
+      for (uint32_t walker_idx = 0; walker_idx < num_walkers; walker_idx++)
+	walker_threads.push_back(std::thread(WalkerSweep<SimulationType>(walkers[walker_idx], parameters.sweep_steps)));
+      for (uint32_t walker_idx = 0; walker_idx < num_walkers; walker_idx++)
+	walker_threads[walker_idx].join();
+
+      for (uint32_t walker_idx = 0; walker_idx < num_walkers; walker_idx++)
+	{
+	  walker_log_dos[walker_idx] = walkers[walker_idx]->get_log_density_of_states();
+	  walker_incidence_counters[walker_idx] = walkers[walker_idx]->get_incidence_counter();
+	}
+      shared_log_dos = mcchd::merge_walker_deltas(shared_log_dos, walker_log_dos);
+      shared_incidence_counter = mcchd::merge_walker_deltas(shared_incidence_counter, walker_incidence_counters);
+
+      const double current_flatness = shared_incidence_counter.flatness();
+      BOOST_LOG_TRIVIAL(info) << "Sweep " << sweep << " of " << num_walkers << " walkers completed with \tm= " << modification_factor << " \tf= " << current_flatness;
+      if (current_flatness >= parameters.flatness)
+	{
+	  modification_factor *= parameters.modification_factor_multiplier;
+	  shared_incidence_counter.set_all_y_values(0);
+
+	  HistogramType normalized_log_dos = shared_log_dos;
+	  normalized_log_dos.shift_bin_zero(normalized_log_dos.min_x_value());
+	  const time_t current_time = time (NULL);
+	  char world_time[16];
+	  strftime (world_time, 16, "%Y%m%d-%H%M%S", gmtime(&current_time));
+	  write_dos_to_file(output_directory + "/modfac_entropy_dump," + world_time + ",mod=" + (boost::format("%e") % modification_factor).str(), normalized_log_dos);
+	}
+
+      if (snapshot_signal || termination_signal)
+	{
+	  snapshot_signal = 0;
+	  HistogramType normalized_log_dos = shared_log_dos;
+	  normalized_log_dos.shift_bin_zero(normalized_log_dos.min_x_value());
+	  const time_t current_time = time (NULL);
+	  char world_time[16];
+	  strftime (world_time, 16, "%Y%m%d-%H%M%S", gmtime(&current_time));
+	  write_dos_to_file(output_directory + "/intermediate_entropy," + world_time, normalized_log_dos);
+	}
+      if (termination_signal)
+	{
+	  BOOST_LOG_TRIVIAL(info) << "Caught SIGTERM. Exiting after sweep " << sweep << ".";
+	  exit(2);
+	}
+
+      for (uint32_t walker_idx = 0; walker_idx < num_walkers; walker_idx++)
+	{
+	  walkers[walker_idx]->set_log_density_of_states(shared_log_dos);
+	  walkers[walker_idx]->set_incidence_counter(shared_incidence_counter);
+	  walkers[walker_idx]->set_modification_factor_current(modification_factor);
+	}
+    }
+
+  shared_log_dos.shift_bin_zero(shared_log_dos.min_x_value());
+  write_dos_to_file(output_directory + "/final_entropy", shared_log_dos);
+
+  for (uint32_t walker_idx = 0; walker_idx < num_walkers; walker_idx++)
+    {
+      delete walkers[walker_idx];
+      delete configurations[walker_idx];
+    }
 }
 
 // declaration of the main simulation routine -- defined below
-void run_simulation(boost_po::variables_map&, std::string&);
+template <class ContainerType> void run_simulation(boost_po::variables_map&, std::string&);
+
+/// runs the simulation with the container passed by dispatch_container
+struct SimulationRunner
+{
+  boost_po::variables_map& option_arguments;
+  std::string& program_name;
+
+  SimulationRunner(boost_po::variables_map& new_option_arguments, std::string& new_program_name) : option_arguments(new_option_arguments), program_name(new_program_name) {}
+  template <class ContainerType> void run()
+  {
+    run_simulation<ContainerType>(option_arguments, program_name);
+  }
+};
 
 
 int main(int argc, char* argv[])
@@ -209,15 +703,26 @@ int main(int argc, char* argv[])
         ("height,h,y", boost_po::value<double>()->default_value(10.), "Height of the Box - y coordinate.")
         ("depth,d,z", boost_po::value<double>()->default_value(10.), "Depth of the Box - z coordinate.")
         ("seed,S", boost_po::value<uint32_t>()->default_value(1), "Seed of the Random number generator.")
+        ("container,C", boost_po::value<std::string>()->default_value("Bulk"), (std::string("Geometry of the container, one of ") + mcchd::container_names + ".").c_str())
+        ("voxelized,V", "Answer container checks from a precomputed voxel table.")
         ("flatness,f", boost_po::value<double>()->default_value(0.8), "Flatness criterion, minimum sampling frequency of an energy in relation to mean frequency.")
         ("mod_final,m", boost_po::value<double>()->default_value(1e-2), "Final modification factor.")
         ("mod_start,s", boost_po::value<double>()->default_value(1.0), "Modification factor at beginning of simulation.")
         ("mod_multi,M", boost_po::value<double>()->default_value(0.5), "Modification factor multiplier - gets multiplied whenever flatness is reached.")
+        ("schedule,T", boost_po::value<std::string>()->default_value("geometric"), "Modification factor schedule: geometric, or inverse_time for geometric until N_E/t is reached and N_E/t afterwards (Belardinelli-Pereyra).")
         ("energy_cutoff_lower,e", boost_po::value<energy_type>(), "Set lower energy limit E_min. No lower limit, if parameter is missing.")
         ("energy_cutoff_upper,E", boost_po::value<energy_type>(), "Set upper energy limit E_max. No upper limit, if parameter is missing.")
         ("output_directory,o", boost_po::value<std::string>(), "Directory for the output of results, progress reports etc.")
         ("sweep_steps,N", boost_po::value<double>()->default_value(1e4), "How many steps between 2 flatness checks and corresponding status reports etc.")
 	("logdos_file,i", boost_po::value<std::string>(), "Input CSV file containing the initial entropy estimation.")
+        ("restart,r", boost_po::value<std::string>(), "Checkpoint file to resume from. The other options have to be those of the checkpointed run.")
+        ("checkpoint_interval,t", boost_po::value<double>()->default_value(0.), "Seconds between two checkpoints to <output_directory>/checkpoint, written by a forked process while the simulation goes on. With 0, checkpoints are only written on SIGTERM.")
+        ("cavity_bias,c", "Propose insertions only in cells which can take another disc.")
+        ("windows,W", boost_po::value<uint32_t>()->default_value(1), "Replica exchange Wang Landau: number of overlapping windows of [E_min, E_max], each sampled by its own walker and thread. Needs E_max, no checkpoints or log DOS file.")
+        ("window_overlap,O", boost_po::value<double>()->default_value(mcchd::default_window_overlap), "Share of a window overlapping each of its neighbours.")
+        ("walkers,K", boost_po::value<uint32_t>()->default_value(1), "Number of walkers sharing one entropy estimate, each on its own thread. No checkpoints.")
+        ("tmmc,X", "Collect the transition matrix of the proposed insertions and removals and write its entropy estimate next to the Wang Landau one. The counts are not checkpointed, so no --restart.")
+        ("tmmc_feedback,F", "Like --tmmc, and replace the Wang Landau entropy by the transition matrix estimate at every modification factor change.")
         ;
       
       boost_po::variables_map option_arguments;
@@ -239,7 +744,9 @@ int main(int argc, char* argv[])
       
       std::string program_name = std::string(argv[0]);
 
-      run_simulation(option_arguments, program_name);
+      // one instantiation of the whole simulation per container
+      SimulationRunner simulation_runner(option_arguments, program_name);
+      mcchd::dispatch_container(option_arguments["container"].as<std::string>(), option_arguments.count("voxelized") > 0, simulation_runner);
     }
   catch (std::exception &exceptionX)
     {
@@ -252,8 +759,14 @@ int main(int argc, char* argv[])
 
 
 
+template <class ContainerType>
 void run_simulation(boost_po::variables_map& option_arguments, std::string& program_name)
 {
+  typedef typename SimulationTypes<ContainerType>::ConfigurationType ConfigurationType;
+  typedef typename SimulationTypes<ContainerType>::PreparationSimulationType PreparationSimulationType;
+  typedef typename SimulationTypes<ContainerType>::SimulationType SimulationType;
+  typedef typename SimulationTypes<ContainerType>::CheckpointType CheckpointType;
+
   BOOST_LOG_TRIVIAL(debug) << "Entered run_simulation.";
 
   // read options
@@ -261,11 +774,18 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
   const double y_max = option_arguments["height"].as<double>();
   const double z_max = option_arguments["depth"].as<double>();
   const uint32_t seed = option_arguments["seed"].as<uint32_t>();
+  const std::string container_name = option_arguments["container"].as<std::string>();
   const double flatness = option_arguments["flatness"].as<double>();
   const double mod_final = option_arguments["mod_final"].as<double>();
   const double mod_start = option_arguments["mod_start"].as<double>();
   const double mod_multi = option_arguments["mod_multi"].as<double>();
   const double sweep_steps = option_arguments["sweep_steps"].as<double>();
+  const double checkpoint_interval = option_arguments["checkpoint_interval"].as<double>();
+  const uint32_t num_windows = option_arguments["windows"].as<uint32_t>();
+  const double window_overlap = option_arguments["window_overlap"].as<double>();
+  const uint32_t num_walkers = option_arguments["walkers"].as<uint32_t>();
+  const std::string schedule = option_arguments["schedule"].as<std::string>();
+  const bool tmmc = option_arguments.count("tmmc") > 0 || option_arguments.count("tmmc_feedback") > 0;
 
   bool energy_cutoff_upper_use = false;
   energy_type energy_cutoff_upper = 0;
@@ -288,6 +808,25 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
       throw energy_cutoff_conflict_exception;
     }
 
+  if (num_windows > 1 && (!energy_cutoff_upper_use || option_arguments.count("restart") || option_arguments.count("logdos_file") || checkpoint_interval > 0.))
+    {
+      throw replica_exchange_options_exception;
+    }
+
+  if (num_walkers > 1 && (num_windows > 1 || option_arguments.count("restart") || checkpoint_interval > 0.))
+    {
+      throw multiple_walkers_options_exception;
+    }
+
+  if ((schedule != "geometric" && schedule != "inverse_time") || (schedule == "inverse_time" && (num_windows > 1 || num_walkers > 1)))
+    {
+      throw schedule_options_exception;
+    }
+
+  if (tmmc && (num_windows > 1 || num_walkers > 1 || option_arguments.count("restart")))
+    {
+      throw tmmc_options_exception;
+    }
 
   BOOST_LOG_TRIVIAL(debug) << "Finished reading simulation options.";
 
@@ -299,8 +838,9 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
     }
   else
     {
-      output_directory = (boost::format("%s,x%.1e,y%.1e,z%.1e,S%d,f%.1e,m%.1e,s%.1e,M%.1e,e%d,E%d,N%.1e")
+      output_directory = (boost::format("%s,%s,x%.1e,y%.1e,z%.1e,S%d,f%.1e,m%.1e,s%.1e,M%.1e,e%d,E%d,N%.1e")
 			  % program_name.c_str()
+			  % container_name.c_str()
 			  % x_max
 			  % y_max
 			  % z_max
@@ -330,7 +870,7 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
   // create simulation objects
   mcchd::coordinate_type extents = {{x_max, y_max, z_max}};
 
-  SimulationType::Parameters wang_landau_parameters;
+  typename SimulationType::Parameters wang_landau_parameters;
   wang_landau_parameters.modification_factor_initial = mod_start;
   wang_landau_parameters.modification_factor_final = mod_final;
   wang_landau_parameters.modification_factor_multiplier = mod_multi;
@@ -341,11 +881,56 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
   wang_landau_parameters.use_energy_cutoff_lower = energy_cutoff_lower_use;
   wang_landau_parameters.energy_cutoff_lower = energy_cutoff_lower;
 
+  if (num_windows > 1)
+    {
+      run_replica_exchange<ContainerType>(wang_landau_parameters, extents, option_arguments.count("cavity_bias") > 0, seed,
+					  mcchd::split_energy_range(energy_cutoff_lower, energy_cutoff_upper, num_windows, window_overlap));
+      return;
+    }
+
+  if (num_walkers > 1)
+    {
+      HistogramType initial_log_dos;
+      if (option_arguments.count("logdos_file"))
+	initial_log_dos.load_csv(option_arguments["logdos_file"].as<std::string>().c_str());
+      run_multiple_walkers<ContainerType>(wang_landau_parameters, extents, option_arguments.count("cavity_bias") > 0, seed, num_walkers,
+					  option_arguments.count("logdos_file") ? &initial_log_dos : 0);
+      return;
+    }
+
   ConfigurationType* hard_sphere_configuration = new ConfigurationType(extents);
+  if (option_arguments.count("cavity_bias"))
+    hard_sphere_configuration->set_cavity_bias(true);
+
+  checkpoint_schedule.seed = seed;
+  checkpoint_schedule.flatness = flatness;
+  checkpoint_schedule.interval = checkpoint_interval;
+  checkpoint_schedule.last_time = time(NULL);
+  checkpoint_schedule.sweep_count = 0;
+  checkpoint_schedule.writer_pid = 0;
+
+  modification_schedule.inverse_time = (schedule == "inverse_time");
+  modification_schedule.inverse_time_phase = false;
+  modification_schedule.sweep_steps = sweep_steps;
+
+  // the checkpoint replaces the configuration, and the run starts at its modification factor
+  CheckpointType restart_checkpoint(hard_sphere_configuration);
+  const bool restart = option_arguments.count("restart") > 0;
+  if (restart)
+    {
+      std::string filename = option_arguments["restart"].as<std::string>();
+      BOOST_LOG_TRIVIAL(info) << "Restart option present. Loading checkpoint " << filename.c_str();
+      restart_checkpoint.load(filename);
+      wang_landau_parameters.modification_factor_initial = restart_checkpoint.modification_factor;
+      checkpoint_schedule.sweep_count = restart_checkpoint.sweep_count;
+      // in the 1/t phase the checkpointed modification factor is N_E/t of that sweep
+      modification_schedule.inverse_time_phase = modification_schedule.inverse_time
+	&& restart_checkpoint.modification_factor <= inverse_time_modification_factor(restart_checkpoint.log_density_of_states.size(), restart_checkpoint.sweep_count);
+    }
 
-  if (energy_cutoff_lower_use)
+  if (energy_cutoff_lower_use && !restart)
     {
-      PreparationSimulationType::Parameters preparation_metropolis_parameters;
+      typename PreparationSimulationType::Parameters preparation_metropolis_parameters;
       // preparation_metropolis_parameters.relaxation_steps = 0;
       // preparation_metropolis_parameters.measurement_number = 0;
       // preparation_metropolis_parameters.steps_between_measurement = 1;
@@ -359,13 +944,22 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
   SimulationType* wang_landau_simulation = new SimulationType(wang_landau_parameters, hard_sphere_configuration);
 
   wang_landau_simulation->set_random_seed(seed);
+
+  // collected from here on, the preparation steps above are no Wang Landau steps
+  if (tmmc)
+    {
+      transition_matrix = new mcchd::TransitionMatrix();
+      tmmc_feedback = option_arguments.count("tmmc_feedback") > 0;
+      hard_sphere_configuration->set_transition_matrix(transition_matrix);
+    }
   
   // attach watchers
-  wang_landau_simulation->signal_handler_sigusr1.connect(handle_sig_usr1);
-  wang_landau_simulation->signal_handler_sigusr2.connect(handle_sig_usr2);
-  wang_landau_simulation->signal_handler_sigterm.connect(handle_sig_term);
-  wang_landau_simulation->signal_handler_sweep.connect(sweep_handler);
-  wang_landau_simulation->signal_handler_modfac_change.connect(modfac_handler);
+  wang_landau_simulation->signal_handler_sigusr1.connect(handle_sig_usr1<ContainerType>);
+  wang_landau_simulation->signal_handler_sigusr2.connect(handle_sig_usr2<ContainerType>);
+  wang_landau_simulation->signal_handler_sweep.connect(sweep_handler<ContainerType>);
+  wang_landau_simulation->signal_handler_modfac_change.connect(modfac_handler<ContainerType>);
+  // Mocasinns would stop in the middle of a sweep on SIGTERM, the sweep handler checkpoints and exits at its end instead
+  std::signal(SIGTERM, note_sig_term);
 
   HistogramType entropy_estimation;
   if (option_arguments.count("logdos_file"))
@@ -376,9 +970,35 @@ void run_simulation(boost_po::variables_map& option_arguments, std::string& prog
       wang_landau_simulation->set_log_density_of_states(entropy_estimation);
     }
 
+  if (restart)
+    {
+      wang_landau_simulation->set_log_density_of_states(restart_checkpoint.log_density_of_states);
+      wang_landau_simulation->set_incidence_counter(restart_checkpoint.incidence_counter);
+      wang_landau_simulation->set_modification_factor_current(restart_checkpoint.modification_factor);
+      wang_landau_simulation->set_random_seed(restart_checkpoint.resume_seed);
+      BOOST_LOG_TRIVIAL(info) << "Resuming after sweep " << restart_checkpoint.sweep_count << " at t= " << hard_sphere_configuration->get_simulation_time();
+    }
+
   // run
   wang_landau_simulation->do_wang_landau_simulation();
 
+  reap_checkpoint_writer(true);
+
+  // the 1/t phase lowers the modification factor without a flat histogram, so its last entropy is dumped here
+  if (modification_schedule.inverse_time_phase)
+    modfac_handler<ContainerType>(wang_landau_simulation);
+
+  if (transition_matrix)
+    {
+      HistogramType tmmc_log_density_of_states;
+      transition_matrix->fill_log_density_of_states(tmmc_log_density_of_states);
+      tmmc_log_density_of_states.shift_bin_zero(tmmc_log_density_of_states.min_x_value());
+      write_dos_to_file(output_directory + "/tmmc_entropy", tmmc_log_density_of_states);
+      hard_sphere_configuration->set_transition_matrix(0);
+      delete transition_matrix;
+      transition_matrix = 0;
+    }
+
   delete hard_sphere_configuration;
   delete wang_landau_simulation;
 }
@@ -8,9 +8,18 @@
  *  - point
  *  - disc
  *  - collision functor singular defects
+ *  - voxelized collision functors
+ *  - overlap kernel
  *  - lookup table
  *  - step
  *  - hard dics
+ *  - measurement writer
+ *  - replica exchange windows
+ *  - multiple walkers
+ *  - transition matrix
+ *  - independent chains
+ *  - parallel tempering
+ *  - checkerboard sweeps
  *  - mocacohadi + mocasinns Metropolis
  *  - mocacohadi + mocasinns Wang Landau
  * 
@@ -26,9 +35,18 @@
 #include "test_CollisionFunctor_SingularDefects.hpp"
 #include "test_CollisionFunctor_NodalSurfaces.hpp"
 #include "test_CollisionFunctor_SimpleGeometries.hpp"
+#include "test_CollisionFunctor_Voxelized.hpp"
+#include "test_OverlapKernel.hpp"
 #include "test_LookupTable.hpp"
 #include "test_Step.hpp"
 #include "test_HardDiscs.hpp"
+#include "test_MeasurementWriter.hpp"
+#include "test_ReplicaExchange.hpp"
+#include "test_MultipleWalkers.hpp"
+#include "test_TransitionMatrix.hpp"
+#include "test_IndependentChains.hpp"
+#include "test_ParallelTempering.hpp"
+#include "test_CheckerboardSweeps.hpp"
 #include "test_mcchd_Metropolis.hpp"
 #include "test_mcchd_WangLandau.hpp"
 
@@ -41,9 +59,18 @@ int main()
   runner.addTest(TestCFSingularDefects::suite());
   runner.addTest(TestCFNodalSurfaces::suite());
   runner.addTest(TestCFSimpleGeometries::suite());
+  runner.addTest(TestCFVoxelized::suite());
+  runner.addTest(TestOverlapKernel::suite());
   runner.addTest(TestLookupTable::suite());
   runner.addTest(TestStep::suite());
   runner.addTest(TestHardDiscs::suite());
+  runner.addTest(TestMeasurementWriter::suite());
+  runner.addTest(TestReplicaExchange::suite());
+  runner.addTest(TestMultipleWalkers::suite());
+  runner.addTest(TestTransitionMatrix::suite());
+  runner.addTest(TestIndependentChains::suite());
+  runner.addTest(TestParallelTempering::suite());
+  runner.addTest(TestCheckerboardSweeps::suite());
   runner.addTest(TestMCCHDMetropolis::suite());
   runner.addTest(TestMCCHDWangLandau::suite());
 
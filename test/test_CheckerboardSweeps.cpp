@@ -0,0 +1,109 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_CheckerboardSweeps.cpp
+ * \brief tests for the parallel displacement sweeps
+ * 
+ * The following tests are performed:
+ *  - split of the box into blocks
+ *  - parallel sweeps leave no overlaps, move the discs and repeat with the same seed and threads
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_CheckerboardSweeps.hpp"
+
+#include <vector>
+
+#include <mocasinns/random/boost_random.hpp>
+
+#include <HardDiscs.hpp>
+#include <LookupTable_Fast.hpp>
+#include <CollisionFunctor_SingularDefects.hpp>
+
+typedef mcchd::HardDiscs<mcchd::CF_Bulk, mcchd::LookupTable_Fast> Configuration;
+typedef mcchd::CheckerboardSweeps<Configuration, Mocasinns::Random::Boost_MT19937> Sweeps;
+
+CppUnit::Test* TestCheckerboardSweeps::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestCheckerboardSweeps");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestCheckerboardSweeps>("Checkerboard sweeps: blocks", &TestCheckerboardSweeps::test_blocks) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestCheckerboardSweeps>("Checkerboard sweeps: sweeps", &TestCheckerboardSweeps::test_sweeps) );
+
+  return suite_of_tests;
+}
+
+void TestCheckerboardSweeps::setUp()
+{
+}
+
+void TestCheckerboardSweeps::tearDown()
+{
+}
+
+void TestCheckerboardSweeps::test_blocks()
+{
+  // 20 / min_block_width gives 7 blocks, rounded down to an even number, a thin axis stays whole
+  const mcchd::coordinate_type extents = {{20., 6., 2.}};
+  Configuration configuration(extents);
+  Sweeps sweeps(&configuration, 1, 3);
+  CPPUNIT_ASSERT(sweeps.get_num_blocks()[0] == 6);
+  CPPUNIT_ASSERT(sweeps.get_num_blocks()[1] == 2);
+  CPPUNIT_ASSERT(sweeps.get_num_blocks()[2] == 1);
+  CPPUNIT_ASSERT(sweeps.get_num_threads() == 3);
+
+  // nothing to move
+  CPPUNIT_ASSERT(sweeps.sweep() == 0);
+}
+
+/// random insertions up to num_discs
+void fill_randomly(Configuration& configuration, Mocasinns::Random::Boost_MT19937& rng, const mcchd::disc_id_type& num_discs)
+{
+  while (configuration.get_number_of_discs() < num_discs)
+    {
+      const mcchd::Point center(&rng, configuration.get_extents());
+      if (!configuration.is_overlapping(mcchd::Disc(center, mcchd::no_disc)))
+	configuration.insert_disc(center);
+    }
+}
+
+void TestCheckerboardSweeps::test_sweeps()
+{
+  const mcchd::coordinate_type extents = {{16., 16., 12.}};
+  const mcchd::disc_id_type num_discs = 1200;
+  Mocasinns::Random::Boost_MT19937 rng;
+  Configuration configuration(extents);
+  fill_randomly(configuration, rng, num_discs);
+  Configuration repeated_configuration(extents);
+  for (mcchd::disc_id_type disc_idx = 0; disc_idx < num_discs; disc_idx++)
+    repeated_configuration.insert_disc(configuration.get_disc_center(disc_idx));
+  configuration.set_cavity_bias(true);
+  std::vector<mcchd::Point> start_centers;
+  for (mcchd::disc_id_type disc_idx = 0; disc_idx < num_discs; disc_idx++)
+    start_centers.push_back(configuration.get_disc_center(disc_idx));
+
+  Sweeps sweeps(&configuration, 5, 4);
+  Sweeps repeated_sweeps(&repeated_configuration, 5, 4);
+  CPPUNIT_ASSERT(sweeps.get_num_blocks()[0] == 4);
+  uint64_t accepted_moves = 0;
+  for (uint32_t sweep = 0; sweep < 50; sweep++)
+    {
+      accepted_moves += sweeps.sweep();
+      repeated_sweeps.sweep();
+    }
+  CPPUNIT_ASSERT(accepted_moves > 50 * num_discs / 2);
+  CPPUNIT_ASSERT(configuration.get_simulation_time() == accepted_moves);
+  CPPUNIT_ASSERT(configuration.get_number_of_discs() == num_discs);
+  CPPUNIT_ASSERT(configuration.get_cavity_bias());
+
+  // no overlaps, every disc is found in the lookup table, the same seed and threads repeat the sweeps exactly
+  double mean_displacement = 0.;
+  for (mcchd::disc_id_type disc_idx = 0; disc_idx < num_discs; disc_idx++)
+    {
+      CPPUNIT_ASSERT(!configuration.is_overlapping_after_displacement(disc_idx, mcchd::Point(0., 0., 0.)));
+      CPPUNIT_ASSERT(configuration.is_overlapping(mcchd::Disc(configuration.get_disc_center(disc_idx), mcchd::no_disc)));
+      CPPUNIT_ASSERT(configuration.get_disc_center(disc_idx) == repeated_configuration.get_disc_center(disc_idx));
+      mean_displacement += configuration.get_disc_center(disc_idx).distance(start_centers[disc_idx], extents) / num_discs;
+    }
+  CPPUNIT_ASSERT(mean_displacement > 0.2);
+}
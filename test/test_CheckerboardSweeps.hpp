@@ -0,0 +1,35 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_CheckerboardSweeps.hpp
+ * \brief Checkerboard sweeps test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_CHECKERBOARDSWEEPS_HPP
+#define TEST_CHECKERBOARDSWEEPS_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <CheckerboardSweeps.hpp>
+
+class TestCheckerboardSweeps : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_blocks();
+  void test_sweeps();
+};
+
+
+#endif
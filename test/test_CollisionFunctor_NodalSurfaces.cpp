@@ -4,19 +4,28 @@
  * \file test_CollisionFunctor_NodalSurfaces.cpp
  * \brief Nodal surface CollisionFunctor test
  * 
- * Will contain tests for:
+ * Contains tests for:
  *  - P surface
  *  - D surface
  *  - G surface
  *  - IWP surface
+ *  - accuracy of the per axis sine and cosine
+ *  - batch evaluation
  *
- * tests should be automized and just test symmetries and so on for random points in a unique way.
+ * The surfaces are compared at random points against their level sets
+ * evaluated with std::sin and std::cos. The answers may only differ within
+ * 1e-12 of the surface, the accuracy budget of the functors.
  * 
  * \author Johannes Knauf
  */
 
 #include "test_CollisionFunctor_NodalSurfaces.hpp"
 
+#include <algorithm>
+#include <vector>
+
+#include <cmath>
+
 CppUnit::Test* TestCFNodalSurfaces::suite()
 {
   CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestCollisionFunctor_NodalSurfaces");
@@ -24,6 +33,8 @@ CppUnit::Test* TestCFNodalSurfaces::suite()
   suite_of_tests->addTest( new CppUnit::TestCaller<TestCFNodalSurfaces>("Collision Functor Nodal Surfaces: test point defect", &TestCFNodalSurfaces::test_collision_d) );
   suite_of_tests->addTest( new CppUnit::TestCaller<TestCFNodalSurfaces>("Collision Functor Nodal Surfaces: test line defect", &TestCFNodalSurfaces::test_collision_g) );
   suite_of_tests->addTest( new CppUnit::TestCaller<TestCFNodalSurfaces>("Collision Functor Nodal Surfaces: test plane defect", &TestCFNodalSurfaces::test_collision_iwp) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestCFNodalSurfaces>("Collision Functor Nodal Surfaces: test sine and cosine accuracy", &TestCFNodalSurfaces::test_sincos_accuracy) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestCFNodalSurfaces>("Collision Functor Nodal Surfaces: test batch evaluation", &TestCFNodalSurfaces::test_batch) );
 
   return suite_of_tests;
 }
@@ -38,23 +49,132 @@ void TestCFNodalSurfaces::tearDown()
 {
 }
 
+const double level_set_tolerance = 1e-12;
+
+/// reference level sets with the library trigonometry
+double reference_p(const mcchd::coordinate_type& extents, const mcchd::Point& center)
+{
+  const double x = 2.*M_PI/extents[0] * center.get_coor(0);
+  const double y = 2.*M_PI/extents[1] * center.get_coor(1);
+  const double z = 2.*M_PI/extents[2] * center.get_coor(2);
+  return std::cos(x) + std::cos(y) + std::cos(z);
+}
+
+double reference_d(const mcchd::coordinate_type& extents, const mcchd::Point& center)
+{
+  const double x = 2.*M_PI/extents[0] * center.get_coor(0);
+  const double y = 2.*M_PI/extents[1] * center.get_coor(1);
+  const double z = 2.*M_PI/extents[2] * center.get_coor(2);
+  return (std::sin(x) * std::sin(y) * std::sin(z) + std::sin(x) * std::cos(y) * std::cos(z) +
+	  std::cos(x) * std::sin(y) * std::cos(z) + std::cos(x) * std::cos(y) * std::sin(z));
+}
+
+double reference_g(const mcchd::coordinate_type& extents, const mcchd::Point& center)
+{
+  const double x = 2.*M_PI/extents[0] * center.get_coor(0);
+  const double y = 2.*M_PI/extents[1] * center.get_coor(1);
+  const double z = 2.*M_PI/extents[2] * center.get_coor(2);
+  return std::cos(x) * std::sin(y) + std::cos(y) * std::sin(z) + std::cos(z) * std::sin(x);
+}
+
+double reference_iwp(const mcchd::coordinate_type& extents, const mcchd::Point& center)
+{
+  const double x = 2.*M_PI/extents[0] * center.get_coor(0);
+  const double y = 2.*M_PI/extents[1] * center.get_coor(1);
+  const double z = 2.*M_PI/extents[2] * center.get_coor(2);
+  return 2*(std::cos(x) * std::cos(y) + std::cos(y) * std::cos(z) + std::cos(z) * std::cos(x))
+    - (std::cos(2*x) + std::cos(2*y) + std::cos(2*z));
+}
+
+/// true if the container agrees with the reference level set (collision below or above zero) at random points
+template <class CollisionFunctor>
+bool matches_reference(const mcchd::coordinate_type& extents, double (*reference)(const mcchd::coordinate_type&, const mcchd::Point&), const bool& collides_below)
+{
+  const CollisionFunctor container(extents);
+  Mocasinns::Random::Boost_MT19937 rng;
+  for (uint32_t probe = 0; probe < 100000; probe++)
+    {
+      const mcchd::Point center(&rng, extents);
+      const double level = reference(extents, center);
+      if (fabs(level) < level_set_tolerance)
+	continue;
+      if (container.collides_with(mcchd::Disc(center, mcchd::no_disc)) != (collides_below ? level < 0 : level > 0))
+	return false;
+    }
+  return true;
+}
+
 void TestCFNodalSurfaces::test_collision_p()
 {
   mcchd::CF_PSurface container_p(extents);
+  CPPUNIT_ASSERT(container_p.collides_with(mcchd::Disc(mcchd::Point(2., 3., 1.5), mcchd::no_disc)));
+  CPPUNIT_ASSERT(! container_p.collides_with(mcchd::Disc(mcchd::Point(0., 0., 0.), mcchd::no_disc)));
+  CPPUNIT_ASSERT(matches_reference<mcchd::CF_PSurface>(extents, reference_p, true));
 }
 
 void TestCFNodalSurfaces::test_collision_d()
 {
-  mcchd::CF_DSurface container_d(extents);
+  CPPUNIT_ASSERT(matches_reference<mcchd::CF_DSurface>(extents, reference_d, true));
 }
 
 void TestCFNodalSurfaces::test_collision_g()
 {
-  mcchd::CF_GSurface container_g(extents);
+  CPPUNIT_ASSERT(matches_reference<mcchd::CF_GSurface>(extents, reference_g, true));
 }
 
 void TestCFNodalSurfaces::test_collision_iwp()
 {
-  mcchd::CF_InnerIWPSurface container_inner_iwp(extents);
-  mcchd::CF_OuterIWPSurface container_outer_iwp(extents);
+  CPPUNIT_ASSERT(matches_reference<mcchd::CF_InnerIWPSurface>(extents, reference_iwp, true));
+  CPPUNIT_ASSERT(matches_reference<mcchd::CF_OuterIWPSurface>(extents, reference_iwp, false));
+}
+
+void TestCFNodalSurfaces::test_sincos_accuracy()
+{
+  // angles of the box and of the periodic images next to it
+  double max_error = 0.;
+  for (uint32_t step = 0; step <= 1000000; step++)
+    {
+      const double angle = -2.*M_PI + step * 6.*M_PI / 1000000;
+      double sine, cosine;
+      mcchd::periodic_sincos(angle, sine, cosine);
+      max_error = std::max(max_error, std::max(fabs(sine - std::sin(angle)), fabs(cosine - std::cos(angle))));
+    }
+  CPPUNIT_ASSERT(max_error < 1e-15);
+}
+
+void TestCFNodalSurfaces::test_batch()
+{
+  const mcchd::CF_PSurface container_p(extents);
+  const mcchd::CF_DSurface container_d(extents);
+  const mcchd::CF_GSurface container_g(extents);
+  const mcchd::CF_InnerIWPSurface container_inner_iwp(extents);
+  const mcchd::CF_OuterIWPSurface container_outer_iwp(extents);
+
+  // odd count for the remainder of vectorised loops
+  const std::size_t count = 1001;
+  std::vector<double> xs(count), ys(count), zs(count);
+  Mocasinns::Random::Boost_MT19937 rng;
+  for (std::size_t idx = 0; idx < count; idx++)
+    {
+      const mcchd::Point center(&rng, extents);
+      xs[idx] = center.get_coor(0);
+      ys[idx] = center.get_coor(1);
+      zs[idx] = center.get_coor(2);
+    }
+
+  bool collides_p[count], collides_d[count], collides_g[count], collides_inner_iwp[count], collides_outer_iwp[count];
+  container_p.collides_with(&xs[0], &ys[0], &zs[0], count, collides_p);
+  container_d.collides_with(&xs[0], &ys[0], &zs[0], count, collides_d);
+  container_g.collides_with(&xs[0], &ys[0], &zs[0], count, collides_g);
+  container_inner_iwp.collides_with(&xs[0], &ys[0], &zs[0], count, collides_inner_iwp);
+  container_outer_iwp.collides_with(&xs[0], &ys[0], &zs[0], count, collides_outer_iwp);
+  for (std::size_t idx = 0; idx < count; idx++)
+    {
+      const mcchd::Disc probe_disc(mcchd::Point(xs[idx], ys[idx], zs[idx]), mcchd::no_disc);
+      CPPUNIT_ASSERT(collides_p[idx] == container_p.collides_with(probe_disc));
+      CPPUNIT_ASSERT(collides_d[idx] == container_d.collides_with(probe_disc));
+      CPPUNIT_ASSERT(collides_g[idx] == container_g.collides_with(probe_disc));
+      CPPUNIT_ASSERT(collides_inner_iwp[idx] == container_inner_iwp.collides_with(probe_disc));
+      CPPUNIT_ASSERT(collides_outer_iwp[idx] == container_outer_iwp.collides_with(probe_disc));
+    }
 }
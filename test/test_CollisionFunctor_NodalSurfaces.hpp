@@ -19,6 +19,7 @@
 
 #include <CollisionFunctor_NodalSurfaces.hpp>
 #include <Disc.hpp>
+#include <mocasinns/random/boost_random.hpp>
 
 class TestCFNodalSurfaces : CppUnit::TestFixture
 {
@@ -34,6 +35,8 @@ public:
   void test_collision_d();
   void test_collision_g();
   void test_collision_iwp();
+  void test_sincos_accuracy();
+  void test_batch();
 };
 
 
@@ -0,0 +1,87 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_CollisionFunctor_Voxelized.cpp
+ * \brief Voxelized CollisionFunctor test
+ * 
+ * Compares the voxel table against the exact functor at random points for
+ *  - nodal surfaces
+ *  - spheres and cylinders
+ *  - singular defects
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_CollisionFunctor_Voxelized.hpp"
+
+CppUnit::Test* TestCFVoxelized::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestCollisionFunctor_Voxelized");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestCFVoxelized>("Collision Functor Voxelized: test nodal surfaces", &TestCFVoxelized::test_nodal_surfaces) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestCFVoxelized>("Collision Functor Voxelized: test simple geometries", &TestCFVoxelized::test_simple_geometries) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestCFVoxelized>("Collision Functor Voxelized: test singular defects", &TestCFVoxelized::test_singular_defects) );
+
+  return suite_of_tests;
+}
+
+void TestCFVoxelized::setUp()
+{
+  mcchd::coordinate_type new_extents = {{6., 6., 6.}};
+  extents = new_extents;
+}
+
+void TestCFVoxelized::tearDown()
+{
+}
+
+/// number of random points where the voxel table and the exact functor disagree
+template <class CollisionFunctor>
+uint32_t count_disagreements(const mcchd::coordinate_type& extents)
+{
+  const CollisionFunctor exact_container(extents);
+  const mcchd::CF_Voxelized<CollisionFunctor> voxelized_container(extents);
+  Mocasinns::Random::Boost_MT19937 rng;
+
+  uint32_t disagreements = 0;
+  for (uint32_t probe = 0; probe < 100000; probe++)
+    {
+      const mcchd::Disc probe_disc(mcchd::Point(&rng, extents), mcchd::no_disc);
+      if (voxelized_container.collides_with(probe_disc) != exact_container.collides_with(probe_disc))
+	disagreements++;
+    }
+  return disagreements;
+}
+
+void TestCFVoxelized::test_nodal_surfaces()
+{
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_PSurface>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_DSurface>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_GSurface>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_InnerIWPSurface>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_OuterIWPSurface>(extents) == 0);
+
+  // most trial points have to be answered from the table
+  const mcchd::CF_Voxelized<mcchd::CF_PSurface> voxelized_p(extents);
+  CPPUNIT_ASSERT(voxelized_p.get_boundary_fraction() < 0.25);
+}
+
+void TestCFVoxelized::test_simple_geometries()
+{
+  // the outer geometries need a larger box
+  const mcchd::coordinate_type outer_extents = {{8., 8., 8.}};
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_InnerSphere>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_OuterSphere>(outer_extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_InnerCylinder>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_OuterCylinder>(outer_extents) == 0);
+}
+
+void TestCFVoxelized::test_singular_defects()
+{
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_Bulk>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_PointDefect>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_LineDefect>(extents) == 0);
+  CPPUNIT_ASSERT(count_disagreements<mcchd::CF_PlaneDefect>(extents) == 0);
+
+  const mcchd::CF_Voxelized<mcchd::CF_Bulk> voxelized_bulk(extents);
+  CPPUNIT_ASSERT(voxelized_bulk.get_boundary_fraction() == 0.);
+}
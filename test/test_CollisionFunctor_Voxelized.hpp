@@ -0,0 +1,43 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_CollisionFunctor_Voxelized.hpp
+ * \brief Voxelized CollisionFunctor test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_CF_VOXELIZED_HPP
+#define TEST_CF_VOXELIZED_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <CollisionFunctor_Voxelized.hpp>
+#include <CollisionFunctor_NodalSurfaces.hpp>
+#include <CollisionFunctor_SimpleGeometries.hpp>
+#include <CollisionFunctor_SingularDefects.hpp>
+#include <Disc.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+class TestCFVoxelized : CppUnit::TestFixture
+{
+private:
+  mcchd::coordinate_type extents;
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_nodal_surfaces();
+  void test_simple_geometries();
+  void test_singular_defects();
+};
+
+
+#endif
@@ -0,0 +1,138 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file test_DomainDecomposition.cpp
+ * \brief tests for the grand canonical sweeps split over MPI ranks
+ *
+ * The following tests are performed:
+ *  - slabs too thin for the halo are refused
+ *  - sweeps leave no overlaps, lose no discs and sample the density of a serial Mocasinns Metropolis run at two beta
+ *
+ * Every rank runs the tests, checks are only made on results all ranks agree on, so no rank is left waiting in a collective.
+ *
+ * \author Johannes Knauf
+ */
+
+#include "test_DomainDecomposition.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <boost/mpi/collectives.hpp>
+
+#include <mocasinns/random/boost_random.hpp>
+#include <mocasinns/metropolis.hpp>
+
+#include <HardDiscs.hpp>
+#include <LookupTable_Flat.hpp>
+#include <CollisionFunctor_SingularDefects.hpp>
+
+typedef mcchd::HardDiscs<mcchd::CF_Bulk, mcchd::LookupTable_Flat> Configuration;
+typedef mcchd::DomainDecomposition<Configuration, Mocasinns::Random::Boost_MT19937> Decomposition;
+typedef Mocasinns::Metropolis<Configuration, mcchd::Step<Configuration>, Mocasinns::Random::Boost_MT19937> SerialSimulation;
+
+CppUnit::Test* TestDomainDecomposition::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestDomainDecomposition");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestDomainDecomposition>("Domain decomposition: slabs", &TestDomainDecomposition::test_slabs) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestDomainDecomposition>("Domain decomposition: sweeps", &TestDomainDecomposition::test_sweeps) );
+
+  return suite_of_tests;
+}
+
+void TestDomainDecomposition::setUp()
+{
+}
+
+void TestDomainDecomposition::tearDown()
+{
+}
+
+void TestDomainDecomposition::test_slabs()
+{
+  boost::mpi::communicator world;
+
+  // the initial discs end up with their owners only
+  const mcchd::coordinate_type extents = {{12., 6., 6.}};
+  Configuration configuration(extents);
+  for (uint32_t disc_idx = 0; disc_idx < 12; disc_idx++)
+    configuration.insert_disc(mcchd::Point(disc_idx + 0.5, 3., 3.));
+  Decomposition decomposition(world, &configuration, 1);
+  CPPUNIT_ASSERT(decomposition.get_num_ranks() == world.size());
+  CPPUNIT_ASSERT(decomposition.get_number_of_discs() == 12);
+
+  // one rank takes any box, more ranks need slabs wider than two halos
+  const mcchd::coordinate_type thin_extents = {{2. * mcchd::halo_depth * world.size(), 6., 6.}};
+  Configuration thin_configuration(thin_extents);
+  if (world.size() > 1)
+    CPPUNIT_ASSERT_THROW(Decomposition(world, &thin_configuration, 1), mcchd::bad_slabs_exception);
+}
+
+/// sweeps at beta, checks the gathered box and compares the mean number of discs with a serial Mocasinns Metropolis run at the same beta
+/// Returns the mean number of discs of the sweeps.
+double check_sweeps(boost::mpi::communicator& world, const double& beta)
+{
+  const mcchd::coordinate_type extents = {{12., 6., 6.}};
+  const uint32_t relaxation_sweeps = 100;
+  const uint32_t sweeps = 2000;
+  const uint32_t steps_per_rank = 4000 / world.size();
+
+  Configuration configuration(extents);
+  Decomposition decomposition(world, &configuration, 3);
+  uint64_t accepted_steps = 0;
+  for (uint32_t sweep = 0; sweep < relaxation_sweeps; sweep++)
+    accepted_steps += decomposition.sweep(beta, steps_per_rank);
+  double mean_discs = 0.;
+  for (uint32_t sweep = 0; sweep < sweeps; sweep++)
+    {
+      accepted_steps += decomposition.sweep(beta, steps_per_rank);
+      mean_discs += static_cast<double> (decomposition.get_number_of_discs()) / sweeps;
+    }
+  CPPUNIT_ASSERT(configuration.get_simulation_time() == accepted_steps);
+
+  // rank 0 puts the whole box together again
+  const std::vector<mcchd::Point> centers = decomposition.gather_disc_centers();
+  const mcchd::disc_id_type num_discs = decomposition.get_number_of_discs();
+  bool all_gathered = true;
+  bool no_overlaps = true;
+  double serial_mean_discs = 0.;
+  if (world.rank() == 0)
+    {
+      Configuration gathered_configuration(extents);
+      for (std::size_t disc_idx = 0; disc_idx < centers.size(); disc_idx++)
+	{
+	  no_overlaps = no_overlaps && !gathered_configuration.is_overlapping(mcchd::Disc(centers[disc_idx], mcchd::no_disc));
+	  gathered_configuration.insert_disc(centers[disc_idx]);
+	}
+      all_gathered = (centers.size() == num_discs);
+
+      // same number of steps on one configuration, stepped as in mcchd_metropolis
+      Configuration serial_configuration(extents);
+      SerialSimulation::Parameters parameters;
+      SerialSimulation serial_simulation(parameters, &serial_configuration);
+      serial_simulation.do_metropolis_steps(relaxation_sweeps * 4000, beta);
+      for (uint32_t sweep = 0; sweep < sweeps; sweep++)
+	{
+	  serial_simulation.do_metropolis_steps(4000, beta);
+	  serial_mean_discs += static_cast<double> (serial_configuration.get_number_of_discs()) / sweeps;
+	}
+    }
+  boost::mpi::broadcast(world, all_gathered, 0);
+  boost::mpi::broadcast(world, no_overlaps, 0);
+  boost::mpi::broadcast(world, serial_mean_discs, 0);
+
+  CPPUNIT_ASSERT(all_gathered);
+  CPPUNIT_ASSERT(no_overlaps);
+  CPPUNIT_ASSERT(num_discs > 20);
+  CPPUNIT_ASSERT(fabs(mean_discs / serial_mean_discs - 1.) < 0.03);
+  return mean_discs;
+}
+
+void TestDomainDecomposition::test_sweeps()
+{
+  boost::mpi::communicator world;
+  // weights exp(-beta N), beta mu 0 and -1
+  const double dense_mean_discs = check_sweeps(world, 0.);
+  const double dilute_mean_discs = check_sweeps(world, 1.);
+  CPPUNIT_ASSERT(dilute_mean_discs < 0.8 * dense_mean_discs);
+}
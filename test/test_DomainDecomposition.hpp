@@ -0,0 +1,35 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_DomainDecomposition.hpp
+ * \brief MPI domain decomposition test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_DOMAINDECOMPOSITION_HPP
+#define TEST_DOMAINDECOMPOSITION_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <DomainDecomposition.hpp>
+
+class TestDomainDecomposition : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_slabs();
+  void test_sweeps();
+};
+
+
+#endif
@@ -8,17 +8,31 @@
  *  - placement of discs
  *  - removal of discs
  *  - check overlap with existing discs
+ *  - fixed point coordinates against double coordinates
+ *  - free cell index and cavity biased insertions
+ *  - checkpoint round trip and continuation
  * 
  * \author Johannes Knauf
  */
 
 #include "test_HardDiscs.hpp"
 
+#include <map>
+#include <fstream>
+#include <cstdio>
+
+#include <boost/serialization/map.hpp>
+
+#include <Checkpoint.hpp>
+
 CppUnit::Test* TestHardDiscs::suite()
 {
   CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestHardDiscs");
   suite_of_tests->addTest( new CppUnit::TestCaller<TestHardDiscs>("Hard Discs: test insert/remove disc functions", &TestHardDiscs::test_placement) );
   suite_of_tests->addTest( new CppUnit::TestCaller<TestHardDiscs>("Hard Discs: test overlap test", &TestHardDiscs::test_overlap) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestHardDiscs>("Hard Discs: test fixed point coordinates", &TestHardDiscs::test_fixed_point) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestHardDiscs>("Hard Discs: test cavity biased insertion", &TestHardDiscs::test_cavity_bias) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestHardDiscs>("Hard Discs: test checkpoint and restart", &TestHardDiscs::test_checkpoint) );
   
   return suite_of_tests;
 }
@@ -46,6 +60,10 @@ void TestHardDiscs::test_placement()
   CPPUNIT_ASSERT(hard_disc_configuration->get_number_of_discs() == 4);
   hard_disc_configuration->remove_disc(2);
   CPPUNIT_ASSERT(hard_disc_configuration->get_number_of_discs() == 3);
+  // the last disc takes the place of the removed one
+  CPPUNIT_ASSERT(hard_disc_configuration->get_disc_center(2) == mcchd::Point(3,1,1));
+  CPPUNIT_ASSERT(hard_disc_configuration->is_overlapping(mcchd::Disc(mcchd::Point(3.1,1.1,1.1), mcchd::no_disc)));
+  CPPUNIT_ASSERT(! hard_disc_configuration->is_overlapping(mcchd::Disc(mcchd::Point(1.1,1.1,1.1), mcchd::no_disc)));
   hard_disc_configuration->remove_disc(2);
   CPPUNIT_ASSERT(hard_disc_configuration->get_number_of_discs() == 2);
 }
@@ -59,3 +77,180 @@ void TestHardDiscs::test_overlap()
   CPPUNIT_ASSERT(hard_disc_configuration->is_overlapping(mcchd::Disc(mcchd::Point(2.4,2.4,2.6), 1))); // overlapping with container, i.e. point defect in center
 }
 
+
+void TestHardDiscs::test_fixed_point()
+{
+  typedef mcchd::HardDiscs<mcchd::CF_Bulk> DoubleConfiguration;
+  typedef mcchd::HardDiscs<mcchd::CF_Bulk, mcchd::LookupTable_Fast, mcchd::DiscPositions_FixedPoint> FixedConfiguration;
+  const mcchd::coordinate_type extents = {{5., 4., 3.}};
+
+  // periodic wrap by integer overflow
+  mcchd::DiscPositions_FixedPoint positions(2, extents);
+  positions.append(mcchd::Point(0.1, 3.9, 1.5));
+  const mcchd::Point wrapped = positions.to_point(positions.get_displaced_stored_center(0, mcchd::Point(-0.3, 0.2, 0.)));
+  CPPUNIT_ASSERT(wrapped.distance(mcchd::Point(4.8, 0.1, 1.5)) < 1e-8);
+
+  // same Markov chain as with double coordinates, most removals are skipped to get a dense system
+  DoubleConfiguration double_configuration(extents);
+  FixedConfiguration fixed_configuration(extents);
+  Mocasinns::Random::Boost_MT19937 double_rng;
+  Mocasinns::Random::Boost_MT19937 fixed_rng;
+  for (uint32_t step = 0; step < 20000; step++)
+    {
+      mcchd::Step<DoubleConfiguration> double_step = double_configuration.propose_step(&double_rng);
+      mcchd::Step<FixedConfiguration> fixed_step = fixed_configuration.propose_step(&fixed_rng);
+      const bool executable = double_step.is_executable();
+      CPPUNIT_ASSERT(fixed_step.is_executable() == executable);
+      if (executable && (double_step.delta_E() >= 0 || step % 10 == 0))
+	{
+	  double_step.execute();
+	  fixed_step.execute();
+	}
+    }
+
+  CPPUNIT_ASSERT(double_configuration.get_number_of_discs() > 10);
+  CPPUNIT_ASSERT(fixed_configuration.get_number_of_discs() == double_configuration.get_number_of_discs());
+  for (mcchd::disc_id_type disc_idx = 0; disc_idx < double_configuration.get_number_of_discs(); disc_idx++)
+    CPPUNIT_ASSERT(fixed_configuration.get_disc_center(disc_idx).distance(double_configuration.get_disc_center(disc_idx), extents) < 1e-6);
+}
+
+/// mean number of discs of a grand canonical run, Metropolis acceptance from the selection probability factor
+template <class Configuration>
+double mean_number_of_discs(Configuration& configuration, const double& beta_mu, const uint32_t& steps)
+{
+  Mocasinns::Random::Boost_MT19937 rng;
+  double sum_discs = 0.;
+  for (uint32_t step = 0; step < steps; step++)
+    {
+      mcchd::Step<Configuration> proposed_step = configuration.propose_step(&rng);
+      if (proposed_step.is_executable())
+	{
+	  const double delta_N = proposed_step.is_move_step() ? 0. : (proposed_step.is_remove_step() ? -1. : 1.);
+	  if (rng.random_double() < exp(beta_mu * delta_N) / proposed_step.selection_probability_factor())
+	    proposed_step.execute();
+	}
+      sum_discs += configuration.get_number_of_discs();
+    }
+  return sum_discs / steps;
+}
+
+void TestHardDiscs::test_cavity_bias()
+{
+  typedef mcchd::HardDiscs<mcchd::CF_Bulk> Configuration;
+  const mcchd::coordinate_type extents = {{5., 4., 3.}};
+  Mocasinns::Random::Boost_MT19937 rng;
+
+  Configuration configuration(extents);
+  configuration.set_cavity_bias(true);
+  CPPUNIT_ASSERT(configuration.get_cavity_bias());
+  CPPUNIT_ASSERT(fabs(configuration.get_insertion_volume() - configuration.get_volume()) < 1e-8);
+
+  // removals are skipped to get a dense system
+  for (uint32_t step = 0; step < 20000; step++)
+    {
+      mcchd::Step<Configuration> proposed_step = configuration.propose_step(&rng);
+      if (proposed_step.is_executable() && ! proposed_step.is_remove_step())
+	proposed_step.execute();
+
+      if (step % 1000 != 0)
+	continue;
+
+      // the incrementally kept index has to match a freshly built one
+      mcchd::FreeCellIndex fresh_index(extents);
+      for (mcchd::disc_id_type disc_idx = 0; disc_idx < configuration.get_number_of_discs(); disc_idx++)
+	fresh_index.insert_disc(configuration.get_disc_center(disc_idx));
+      CPPUNIT_ASSERT(fabs(fresh_index.get_free_volume() - configuration.get_insertion_volume()) < 1e-8);
+      CPPUNIT_ASSERT(fabs(fresh_index.get_free_volume_without(configuration.get_disc_center(0)) - configuration.get_insertion_volume_without(0)) < 1e-8);
+
+      // no place a disc fits is left out
+      for (uint32_t probe = 0; probe < 100; probe++)
+	{
+	  const mcchd::Point probe_point(&rng, extents);
+	  CPPUNIT_ASSERT(configuration.is_overlapping(mcchd::Disc(probe_point, mcchd::no_disc)) || fresh_index.is_free(probe_point));
+	}
+    }
+  CPPUNIT_ASSERT(configuration.get_number_of_discs() > 10);
+  CPPUNIT_ASSERT(configuration.get_insertion_volume() < 0.5 * configuration.get_volume());
+
+  // same grand canonical ensemble with and without cavity bias
+  Configuration uniform_configuration(extents);
+  Configuration biased_configuration(extents);
+  biased_configuration.set_cavity_bias(true);
+  const double uniform_mean = mean_number_of_discs(uniform_configuration, 2., 400000);
+  const double biased_mean = mean_number_of_discs(biased_configuration, 2., 400000);
+  CPPUNIT_ASSERT(fabs(biased_mean - uniform_mean) < 0.02 * uniform_mean);
+}
+
+void TestHardDiscs::test_checkpoint()
+{
+  typedef mcchd::HardDiscs<mcchd::CF_Bulk> Configuration;
+  typedef mcchd::Checkpoint<Configuration, std::map<mcchd::energy_type, double>, std::map<mcchd::energy_type, long unsigned int> > CheckpointType;
+  const mcchd::coordinate_type extents = {{5., 4., 3.}};
+  const std::string filename = "test_HardDiscs.checkpoint";
+  Mocasinns::Random::Boost_MT19937 rng;
+
+  Configuration configuration(extents);
+  configuration.set_cavity_bias(true);
+  for (uint32_t step = 0; step < 5000; step++)
+    {
+      mcchd::Step<Configuration> proposed_step = configuration.propose_step(&rng);
+      if (proposed_step.is_executable() && (! proposed_step.is_remove_step() || step % 10 == 0))
+	proposed_step.execute();
+    }
+
+  CheckpointType saved_checkpoint(&configuration);
+  saved_checkpoint.log_density_of_states[3] = 1.5;
+  saved_checkpoint.incidence_counter[3] = 42;
+  saved_checkpoint.modification_factor = 0.125;
+  saved_checkpoint.sweep_count = 17;
+  saved_checkpoint.resume_seed = mcchd::mix_seed(1, 17);
+  saved_checkpoint.save(filename);
+
+  // loading replaces the discs already present
+  Configuration restarted_configuration(extents);
+  restarted_configuration.insert_disc(mcchd::Point(1., 1., 1.));
+  CheckpointType loaded_checkpoint(&restarted_configuration);
+  loaded_checkpoint.load(filename);
+
+  CPPUNIT_ASSERT(loaded_checkpoint.log_density_of_states == saved_checkpoint.log_density_of_states);
+  CPPUNIT_ASSERT(loaded_checkpoint.incidence_counter == saved_checkpoint.incidence_counter);
+  CPPUNIT_ASSERT(loaded_checkpoint.modification_factor == 0.125);
+  CPPUNIT_ASSERT(loaded_checkpoint.sweep_count == 17);
+  CPPUNIT_ASSERT(loaded_checkpoint.resume_seed == saved_checkpoint.resume_seed);
+  CPPUNIT_ASSERT(restarted_configuration.get_simulation_time() == configuration.get_simulation_time());
+  CPPUNIT_ASSERT(restarted_configuration.get_cavity_bias());
+  CPPUNIT_ASSERT(restarted_configuration.get_insertion_volume() == configuration.get_insertion_volume());
+  CPPUNIT_ASSERT(restarted_configuration.get_number_of_discs() == configuration.get_number_of_discs());
+  CPPUNIT_ASSERT(restarted_configuration.get_number_of_discs() > 10);
+
+  // both continue bit by bit the same
+  Mocasinns::Random::Boost_MT19937 rng_continued(loaded_checkpoint.resume_seed);
+  Mocasinns::Random::Boost_MT19937 rng_restarted(loaded_checkpoint.resume_seed);
+  for (uint32_t step = 0; step < 5000; step++)
+    {
+      mcchd::Step<Configuration> continued_step = configuration.propose_step(&rng_continued);
+      mcchd::Step<Configuration> restarted_step = restarted_configuration.propose_step(&rng_restarted);
+      const bool executable = continued_step.is_executable();
+      CPPUNIT_ASSERT(restarted_step.is_executable() == executable);
+      CPPUNIT_ASSERT(restarted_step.selection_probability_factor() == continued_step.selection_probability_factor());
+      if (executable)
+	{
+	  continued_step.execute();
+	  restarted_step.execute();
+	}
+    }
+  CPPUNIT_ASSERT(restarted_configuration.get_number_of_discs() == configuration.get_number_of_discs());
+  for (mcchd::disc_id_type disc_idx = 0; disc_idx < configuration.get_number_of_discs(); disc_idx++)
+    CPPUNIT_ASSERT(restarted_configuration.get_disc_center(disc_idx) == configuration.get_disc_center(disc_idx));
+
+  // other box
+  const mcchd::coordinate_type other_extents = {{5., 4., 4.}};
+  Configuration other_configuration(other_extents);
+  CheckpointType other_checkpoint(&other_configuration);
+  CPPUNIT_ASSERT_THROW(other_checkpoint.load(filename), mcchd::extents_mismatch_exception);
+
+  // no checkpoint at all
+  std::ofstream(filename.c_str()) << "no checkpoint";
+  CPPUNIT_ASSERT_THROW(other_checkpoint.load(filename), std::exception);
+  std::remove(filename.c_str());
+}
@@ -19,6 +19,7 @@
 
 #include <HardDiscs.hpp>
 #include <CollisionFunctor_SingularDefects.hpp>
+#include <mocasinns/random/boost_random.hpp>
 
 class TestHardDiscs : CppUnit::TestFixture
 {
@@ -32,6 +33,9 @@ public:
 
   void test_placement();
   void test_overlap();
+  void test_fixed_point();
+  void test_cavity_bias();
+  void test_checkpoint();
 };
 
 
@@ -0,0 +1,120 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_IndependentChains.cpp
+ * \brief tests for the helpers of independent Metropolis chains
+ * 
+ * The following tests are performed:
+ *  - distinct seeds of the chains
+ *  - running averages merged against the average of all values
+ *  - every task run exactly once by the thread pool, exceptions passed on
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_IndependentChains.hpp"
+
+#include <set>
+#include <vector>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+
+CppUnit::Test* TestIndependentChains::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestIndependentChains");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestIndependentChains>("Independent chains: seeds", &TestIndependentChains::test_seeds) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestIndependentChains>("Independent chains: running average", &TestIndependentChains::test_running_average) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestIndependentChains>("Independent chains: thread pool", &TestIndependentChains::test_thread_pool) );
+
+  return suite_of_tests;
+}
+
+void TestIndependentChains::setUp()
+{
+}
+
+void TestIndependentChains::tearDown()
+{
+}
+
+void TestIndependentChains::test_seeds()
+{
+  // neighbouring seeds and neighbouring chains must not share a stream
+  std::set<uint32_t> seeds;
+  for (uint32_t seed = 1; seed <= 4; seed++)
+    for (uint32_t chain_idx = 0; chain_idx < 1000; chain_idx++)
+      seeds.insert(mcchd::mix_seed(seed, chain_idx));
+  CPPUNIT_ASSERT(seeds.size() == 4000);
+  CPPUNIT_ASSERT(mcchd::mix_seed(1, 7) == mcchd::mix_seed(1, 7));
+}
+
+void TestIndependentChains::test_running_average()
+{
+  mcchd::RunningAverage all_values;
+  std::vector<mcchd::RunningAverage> chains(3);
+  for (uint32_t value_idx = 0; value_idx < 100; value_idx++)
+    {
+      const double value = value_idx * value_idx % 17;
+      all_values.add(value);
+      chains[value_idx % 3].add(value);
+    }
+  CPPUNIT_ASSERT(all_values.get_count() == 100);
+  CPPUNIT_ASSERT(fabs(all_values.get_mean() - 8.11) < 1e-12);
+
+  mcchd::RunningAverage pooled;
+  pooled.merge(mcchd::RunningAverage());
+  for (uint32_t chain_idx = 0; chain_idx < chains.size(); chain_idx++)
+    pooled.merge(chains[chain_idx]);
+  CPPUNIT_ASSERT(pooled.get_count() == all_values.get_count());
+  CPPUNIT_ASSERT(fabs(pooled.get_mean() - all_values.get_mean()) < 1e-12);
+  CPPUNIT_ASSERT(fabs(pooled.get_variance() - all_values.get_variance()) < 1e-10);
+
+  CPPUNIT_ASSERT(mcchd::RunningAverage().get_variance() == 0.);
+}
+
+/// counts how often each task ran, task 13 throws if asked to
+struct CountingTask
+{
+  std::vector<std::atomic<uint32_t> > runs;
+  bool throw_at_13;
+
+  CountingTask(const uint32_t& num_tasks) : runs(num_tasks), throw_at_13(false)
+  {
+    for (uint32_t task_idx = 0; task_idx < num_tasks; task_idx++)
+      runs[task_idx] = 0;
+  }
+  void operator()(const uint32_t& task_idx)
+  {
+    runs[task_idx]++;
+    if (throw_at_13 && task_idx == 13)
+      throw std::runtime_error("task 13");
+  }
+};
+
+void TestIndependentChains::test_thread_pool()
+{
+  // more tasks than threads, more threads than tasks, one per core
+  const uint32_t pool_sizes[] = {3, 100, 0};
+  for (uint32_t size_idx = 0; size_idx < 3; size_idx++)
+    {
+      CountingTask task(50);
+      mcchd::run_on_thread_pool(task, 50, pool_sizes[size_idx]);
+      for (uint32_t task_idx = 0; task_idx < 50; task_idx++)
+	CPPUNIT_ASSERT(task.runs[task_idx] == 1);
+    }
+
+  CountingTask throwing_task(50);
+  throwing_task.throw_at_13 = true;
+  CPPUNIT_ASSERT_THROW(mcchd::run_on_thread_pool(throwing_task, 50, 4), std::runtime_error);
+  CPPUNIT_ASSERT(throwing_task.runs[13] == 1);
+
+  // chain index first in the text output
+  mcchd::ChainMeasurement<uint32_t> measurement;
+  measurement.chain = 3;
+  measurement.value = 42;
+  std::ostringstream output_stream;
+  output_stream << measurement;
+  CPPUNIT_ASSERT(output_stream.str() == "3\t42");
+}
@@ -0,0 +1,36 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_IndependentChains.hpp
+ * \brief Independent chains test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_INDEPENDENTCHAINS_HPP
+#define TEST_INDEPENDENTCHAINS_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <IndependentChains.hpp>
+
+class TestIndependentChains : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_seeds();
+  void test_running_average();
+  void test_thread_pool();
+};
+
+
+#endif
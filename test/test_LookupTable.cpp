@@ -7,17 +7,29 @@
  * Contains tests for
  *  - getting neighbour lists
  *  - removing and inserting discs
+ *  - occupied cells as sure overlaps
+ *  - flat index grid and coordinates in cell grid against the multi_array grid
+ *  - cells of fixed point centers against those of points
+ *  - early exit overlap query against brute force
+ *  - single precision grid at contact distance
+ *  - multi occupancy grid
  * \author Johannes Knauf
  */
 
 #include "test_LookupTable.hpp"
 
+#include <algorithm>
+
 CppUnit::Test* TestLookupTable::suite()
 {
   CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestLookupTable");
   suite_of_tests->addTest( new CppUnit::TestCaller<TestLookupTable>("LookupTable: test get neighbours function", &TestLookupTable::test_get_neighbours) );
   suite_of_tests->addTest( new CppUnit::TestCaller<TestLookupTable>("LookupTable: test remove and insert function", &TestLookupTable::test_remove_insert) );
   suite_of_tests->addTest( new CppUnit::TestCaller<TestLookupTable>("LookupTable: test randomized", &TestLookupTable::test_randomized) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestLookupTable>("LookupTable: test flat index and coordinates in cell grids", &TestLookupTable::test_flat_table) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestLookupTable>("LookupTable: test fixed point cells", &TestLookupTable::test_fixed_point_cells) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestLookupTable>("LookupTable: test single precision grid", &TestLookupTable::test_float_table) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestLookupTable>("LookupTable: test multi occupancy grid", &TestLookupTable::test_multi_table) );
   
   return suite_of_tests;
 }
@@ -34,7 +46,7 @@ void TestLookupTable::setUp()
   test_discs.push_back(new mcchd::Disc(mcchd::Point(0.8,1.4,4), 4));
   test_discs.push_back(new mcchd::Disc(mcchd::Point(3,3,3), 5));
   for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
-    disc_table->insert_disc(*disc_it);
+    disc_table->insert_disc((*disc_it)->get_id(), (*disc_it)->get_center());
 }
 
 void TestLookupTable::tearDown()
@@ -53,11 +65,11 @@ void TestLookupTable::test_get_neighbours()
   CPPUNIT_ASSERT(neighbours.size() == 3);
   mcchd::DiscVec::const_iterator neighbour_cit = neighbours.begin();
 
-  CPPUNIT_ASSERT((*neighbour_cit)->get_center() == mcchd::Point(0.8,1.4,4) || (*neighbour_cit)->get_center() == mcchd::Point(1.8,1.4,4) || (*neighbour_cit)->get_center() == mcchd::Point(1,1,1) || (*neighbour_cit)->get_center() == mcchd::Point(1,2,4));
+  CPPUNIT_ASSERT(test_discs[*neighbour_cit]->get_center() == mcchd::Point(0.8,1.4,4) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1.8,1.4,4) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1,1,1) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1,2,4));
   neighbour_cit++;
-  CPPUNIT_ASSERT((*neighbour_cit)->get_center() == mcchd::Point(0.8,1.4,4) || (*neighbour_cit)->get_center() == mcchd::Point(1.8,1.4,4) || (*neighbour_cit)->get_center() == mcchd::Point(1,1,1) || (*neighbour_cit)->get_center() == mcchd::Point(1,2,4));
+  CPPUNIT_ASSERT(test_discs[*neighbour_cit]->get_center() == mcchd::Point(0.8,1.4,4) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1.8,1.4,4) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1,1,1) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1,2,4));
   neighbour_cit++;
-  CPPUNIT_ASSERT((*neighbour_cit)->get_center() == mcchd::Point(0.8,1.4,4) || (*neighbour_cit)->get_center() == mcchd::Point(1.8,1.4,4) || (*neighbour_cit)->get_center() == mcchd::Point(1,1,1) || (*neighbour_cit)->get_center() == mcchd::Point(1,2,4));
+  CPPUNIT_ASSERT(test_discs[*neighbour_cit]->get_center() == mcchd::Point(0.8,1.4,4) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1.8,1.4,4) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1,1,1) || test_discs[*neighbour_cit]->get_center() == mcchd::Point(1,2,4));
   neighbour_cit++;
   CPPUNIT_ASSERT(neighbour_cit == neighbours.end());
 }
@@ -65,18 +77,24 @@ void TestLookupTable::test_get_neighbours()
 void TestLookupTable::test_remove_insert()
 {
   for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
-    disc_table->remove_disc(*disc_it);
+    disc_table->remove_disc((*disc_it)->get_id(), (*disc_it)->get_center());
 
   CPPUNIT_ASSERT(disc_table->get_neighbouring_discs(mcchd::Point(1,2,4)).size() == 0);
 
+  CPPUNIT_ASSERT(! disc_table->cell_occupied(mcchd::Point(4.3, 2.1, 0.2)));
+
   mcchd::Disc* new_test_disc = new mcchd::Disc(mcchd::Point(4.3, 2.1, 0.2), 6);
-  disc_table->insert_disc(new_test_disc);
+  disc_table->insert_disc(new_test_disc->get_id(), new_test_disc->get_center());
+  CPPUNIT_ASSERT(disc_table->cell_occupied(mcchd::Point(4.3, 2.1, 0.2)));
   CPPUNIT_ASSERT(disc_table->get_neighbouring_discs(mcchd::Point(4,2,1)).size() == 1);
-  disc_table->remove_disc(new_test_disc);
+  disc_table->renumber_disc(new_test_disc->get_id(), 7, new_test_disc->get_center());
+  CPPUNIT_ASSERT(disc_table->get_neighbouring_discs(mcchd::Point(4,2,1)) == mcchd::DiscVec(1, 7));
+  disc_table->remove_disc(7, new_test_disc->get_center());
   delete new_test_disc;
+  CPPUNIT_ASSERT(! disc_table->cell_occupied(mcchd::Point(4.3, 2.1, 0.2)));
 
   for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
-    disc_table->insert_disc(*disc_it);
+    disc_table->insert_disc((*disc_it)->get_id(), (*disc_it)->get_center());
 
   
 }
@@ -85,5 +103,222 @@ void TestLookupTable::test_randomized()
 {
   // insert til nothing is possible any more
   // check collisions against brute force collision check
+  Mocasinns::Random::Boost_MT19937 rng;
+  const mcchd::coordinate_type all_extents[] = {{{5., 5., 5.}}, {{7., 3., 2.}}, {{1.5, 6., 4.}}};
+
+  for (uint32_t box = 0; box < 3; box++)
+    {
+      const mcchd::coordinate_type& extents = all_extents[box];
+      mcchd::LookupTable_Fast fast_table(extents);
+      mcchd::LookupTable_Flat flat_table(extents);
+      mcchd::LookupTable_Packed packed_table(extents);
+      mcchd::LookupTable_PackedFloat float_table(extents);
+      mcchd::LookupTable_Multi multi_table(extents);
+      mcchd::LookupTable_Brute brute_table(extents);
+      mcchd::DiscPositions positions(1000, extents);
+      DiscPtrVec placed_discs;
+
+      uint32_t failed_insertions = 0;
+      while (failed_insertions < 1000)
+	{
+	  mcchd::Disc* candidate = new mcchd::Disc(mcchd::Point(&rng, extents), placed_discs.size());
+	  bool overlaps = false;
+	  for (DiscPtrVec::const_iterator disc_cit = placed_discs.begin(); disc_cit != placed_discs.end(); disc_cit++)
+	    overlaps = overlaps || (*disc_cit)->is_overlapping(*candidate, extents);
+
+	  if (overlaps)
+	    {
+	      failed_insertions++;
+	      delete candidate;
+	    }
+	  else
+	    {
+	      placed_discs.push_back(candidate);
+	      positions.append(candidate->get_center());
+	      fast_table.insert_disc(candidate->get_id(), candidate->get_center());
+	      flat_table.insert_disc(candidate->get_id(), candidate->get_center());
+	      packed_table.insert_disc(candidate->get_id(), candidate->get_center());
+	      float_table.insert_disc(candidate->get_id(), candidate->get_center());
+	      multi_table.insert_disc(candidate->get_id(), candidate->get_center());
+	      brute_table.insert_disc(candidate->get_id(), candidate->get_center());
+	    }
+	}
+
+      // every disc closer than one diameter has to be among the neighbours
+      for (uint32_t probe = 0; probe < 1000; probe++)
+	{
+	  const mcchd::Disc probe_disc(mcchd::Point(&rng, extents), -1);
+	  mcchd::DiscVec fast_neighbours = fast_table.get_neighbouring_discs(probe_disc.get_center());
+	  mcchd::DiscVec flat_neighbours = flat_table.get_neighbouring_discs(probe_disc.get_center());
+	  mcchd::DiscVec packed_neighbours = packed_table.get_neighbouring_discs(probe_disc.get_center());
+	  mcchd::DiscVec float_neighbours = float_table.get_neighbouring_discs(probe_disc.get_center());
+	  mcchd::DiscVec multi_neighbours = multi_table.get_neighbouring_discs(probe_disc.get_center());
+	  bool overlaps = false;
+	  for (DiscPtrVec::const_iterator disc_cit = placed_discs.begin(); disc_cit != placed_discs.end(); disc_cit++)
+	    {
+	      if ((*disc_cit)->is_overlapping(probe_disc, extents))
+		{
+		  overlaps = true;
+		  CPPUNIT_ASSERT(std::find(fast_neighbours.begin(), fast_neighbours.end(), (*disc_cit)->get_id()) != fast_neighbours.end());
+		  CPPUNIT_ASSERT(std::find(flat_neighbours.begin(), flat_neighbours.end(), (*disc_cit)->get_id()) != flat_neighbours.end());
+		  CPPUNIT_ASSERT(std::find(packed_neighbours.begin(), packed_neighbours.end(), (*disc_cit)->get_id()) != packed_neighbours.end());
+		  CPPUNIT_ASSERT(std::find(float_neighbours.begin(), float_neighbours.end(), (*disc_cit)->get_id()) != float_neighbours.end());
+		  CPPUNIT_ASSERT(std::find(multi_neighbours.begin(), multi_neighbours.end(), (*disc_cit)->get_id()) != multi_neighbours.end());
+		}
+	    }
+
+	  const mcchd::DiscOverlapPredicate<> overlaps_probe(positions, probe_disc, extents);
+	  CPPUNIT_ASSERT(fast_table.any_overlap(probe_disc.get_center(), overlaps_probe) == overlaps);
+	  CPPUNIT_ASSERT(flat_table.any_overlap(probe_disc.get_center(), overlaps_probe) == overlaps);
+	  CPPUNIT_ASSERT(packed_table.any_overlap(probe_disc.get_center(), overlaps_probe) == overlaps);
+	  CPPUNIT_ASSERT(float_table.any_overlap(probe_disc.get_center(), overlaps_probe) == overlaps);
+	  CPPUNIT_ASSERT(multi_table.any_overlap(probe_disc.get_center(), overlaps_probe) == overlaps);
+	  CPPUNIT_ASSERT(brute_table.any_overlap(probe_disc.get_center(), overlaps_probe) == overlaps);
+
+	  // an occupied cell is a sure overlap, and all single occupancy grids share their cells
+	  const bool occupied = fast_table.cell_occupied(probe_disc.get_center());
+	  CPPUNIT_ASSERT(! occupied || overlaps);
+	  CPPUNIT_ASSERT(flat_table.cell_occupied(probe_disc.get_center()) == occupied);
+	  CPPUNIT_ASSERT(packed_table.cell_occupied(probe_disc.get_center()) == occupied);
+	  CPPUNIT_ASSERT(float_table.cell_occupied(probe_disc.get_center()) == occupied);
+	  CPPUNIT_ASSERT(! multi_table.cell_occupied(probe_disc.get_center()));
+	  CPPUNIT_ASSERT(! brute_table.cell_occupied(probe_disc.get_center()));
+	}
+
+      while (placed_discs.size() > 0)
+	{
+	  delete placed_discs.back();
+	  placed_discs.pop_back();
+	}
+    }
 }
 
+void TestLookupTable::test_flat_table()
+{
+  mcchd::coordinate_type extents = {{5., 5., 5.}};
+  mcchd::LookupTable_Flat flat_table(extents);
+  mcchd::LookupTable_Packed packed_table(extents);
+  for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
+    {
+      flat_table.insert_disc((*disc_it)->get_id(), (*disc_it)->get_center());
+      packed_table.insert_disc((*disc_it)->get_id(), (*disc_it)->get_center());
+    }
+
+  // both grids have to find exactly the same neighbours
+  const mcchd::Point probes[] = {mcchd::Point(1,2,4), mcchd::Point(4,2,1), mcchd::Point(0.1,4.9,2.5), mcchd::Point(3,3,3)};
+  for (uint32_t probe = 0; probe < 4; probe++)
+    {
+      mcchd::DiscVec flat_neighbours = flat_table.get_neighbouring_discs(probes[probe]);
+      mcchd::DiscVec packed_neighbours = packed_table.get_neighbouring_discs(probes[probe]);
+      mcchd::DiscVec fast_neighbours = disc_table->get_neighbouring_discs(probes[probe]);
+      std::sort(flat_neighbours.begin(), flat_neighbours.end());
+      std::sort(packed_neighbours.begin(), packed_neighbours.end());
+      std::sort(fast_neighbours.begin(), fast_neighbours.end());
+      CPPUNIT_ASSERT(flat_neighbours == fast_neighbours);
+      CPPUNIT_ASSERT(packed_neighbours == fast_neighbours);
+    }
+
+  for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
+    {
+      flat_table.remove_disc((*disc_it)->get_id(), (*disc_it)->get_center());
+      packed_table.remove_disc((*disc_it)->get_id(), (*disc_it)->get_center());
+    }
+  CPPUNIT_ASSERT(flat_table.get_neighbouring_discs(mcchd::Point(1,2,4)).size() == 0);
+  CPPUNIT_ASSERT(packed_table.get_neighbouring_discs(mcchd::Point(1,2,4)).size() == 0);
+}
+
+void TestLookupTable::test_fixed_point_cells()
+{
+  mcchd::coordinate_type extents = {{5., 5., 5.}};
+  mcchd::DiscPositions_FixedPoint positions(1, extents);
+  mcchd::LookupTable_Fast fast_table(extents);
+  mcchd::LookupTable_Flat flat_table(extents);
+  for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
+    {
+      fast_table.insert_disc((*disc_it)->get_id(), positions.to_stored_center((*disc_it)->get_center()));
+      flat_table.insert_disc((*disc_it)->get_id(), positions.to_stored_center((*disc_it)->get_center()));
+    }
+
+  // same neighbours and occupied cells as the points, the extent wraps to 0
+  const mcchd::Point probes[] = {mcchd::Point(1,2,4), mcchd::Point(4,2,1), mcchd::Point(0.1,4.9,2.5), mcchd::Point(3,3,3), mcchd::Point(5.,0.,1.)};
+  for (uint32_t probe = 0; probe < 5; probe++)
+    {
+      const mcchd::fixed_coordinate_type fixed_probe = positions.to_stored_center(probes[probe]);
+      mcchd::DiscVec point_neighbours = disc_table->get_neighbouring_discs(probes[probe]);
+      mcchd::DiscVec fast_neighbours, flat_neighbours;
+      fast_table.any_overlap(fixed_probe, mcchd::NeighbourCollector(fast_neighbours));
+      flat_table.any_overlap(fixed_probe, mcchd::NeighbourCollector(flat_neighbours));
+      std::sort(point_neighbours.begin(), point_neighbours.end());
+      std::sort(fast_neighbours.begin(), fast_neighbours.end());
+      std::sort(flat_neighbours.begin(), flat_neighbours.end());
+      CPPUNIT_ASSERT(fast_neighbours == point_neighbours);
+      CPPUNIT_ASSERT(flat_neighbours == point_neighbours);
+      CPPUNIT_ASSERT(fast_table.cell_occupied(fixed_probe) == disc_table->cell_occupied(probes[probe]));
+      CPPUNIT_ASSERT(flat_table.cell_occupied(fixed_probe) == disc_table->cell_occupied(probes[probe]));
+    }
+
+  for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
+    {
+      fast_table.remove_disc((*disc_it)->get_id(), positions.to_stored_center((*disc_it)->get_center()));
+      flat_table.remove_disc((*disc_it)->get_id(), positions.to_stored_center((*disc_it)->get_center()));
+    }
+  CPPUNIT_ASSERT(fast_table.get_neighbouring_discs(mcchd::Point(1,2,4)).size() == 0);
+  CPPUNIT_ASSERT(flat_table.get_neighbouring_discs(mcchd::Point(1,2,4)).size() == 0);
+}
+
+void TestLookupTable::test_float_table()
+{
+  // probes closer to the contact distance than the float resolution are decided in double precision
+  const mcchd::coordinate_type extents = {{6., 6., 6.}};
+  mcchd::LookupTable_PackedFloat float_table(extents);
+  mcchd::DiscPositions positions(10, extents);
+  const mcchd::Point disc_center(5.7, 1., 1.);
+  float_table.insert_disc(positions.append(disc_center), disc_center);
+
+  const double contact = 2. * mcchd::DEFAULT_DISC_RADIUS;
+  const double offsets[] = {-1e-6, -1e-12, 0., 1e-12, 1e-6};
+  for (uint32_t offset = 0; offset < 5; offset++)
+    {
+      // across the periodic boundary
+      const mcchd::Disc probe_disc(mcchd::Point(5.7 + contact + offsets[offset] - extents[0], 1., 1.), mcchd::no_disc);
+      const mcchd::DiscOverlapPredicate<> overlaps_probe(positions, probe_disc, extents);
+      CPPUNIT_ASSERT(float_table.any_overlap(probe_disc.get_center(), overlaps_probe) == overlaps_probe(0));
+      CPPUNIT_ASSERT(float_table.any_overlap(probe_disc.get_center(), overlaps_probe) == (offsets[offset] < 0.));
+    }
+
+  float_table.remove_disc(0, disc_center);
+  CPPUNIT_ASSERT(float_table.get_neighbouring_discs(disc_center).size() == 0);
+}
+
+void TestLookupTable::test_multi_table()
+{
+  const mcchd::coordinate_type extents = {{10., 20., 30.}};
+  mcchd::LookupTable_Multi multi_table(extents);
+
+  // the centers of at most (1 + 1)^3 / (pi / 6) discs fit into a cell of width 1
+  CPPUNIT_ASSERT(multi_table.get_cell_capacity() == 15);
+
+  for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
+    multi_table.insert_disc((*disc_it)->get_id(), (*disc_it)->get_center());
+
+  // only the 27 cells around the point are visited
+  mcchd::DiscVec neighbours = multi_table.get_neighbouring_discs(mcchd::Point(0.5, 0.5, 0.5));
+  CPPUNIT_ASSERT(std::find(neighbours.begin(), neighbours.end(), test_discs[0]->get_id()) != neighbours.end());
+  neighbours = multi_table.get_neighbouring_discs(mcchd::Point(5.5, 10.5, 15.5));
+  CPPUNIT_ASSERT(std::find(neighbours.begin(), neighbours.end(), test_discs[0]->get_id()) == neighbours.end());
+
+  // renumbered discs are found under the new index only
+  const mcchd::Disc* renumbered = test_discs.back();
+  multi_table.renumber_disc(renumbered->get_id(), 1000, renumbered->get_center());
+  neighbours = multi_table.get_neighbouring_discs(renumbered->get_center());
+  CPPUNIT_ASSERT(std::find(neighbours.begin(), neighbours.end(), 1000) != neighbours.end());
+  CPPUNIT_ASSERT(std::find(neighbours.begin(), neighbours.end(), renumbered->get_id()) == neighbours.end());
+  multi_table.renumber_disc(1000, renumbered->get_id(), renumbered->get_center());
+
+  for (DiscPtrVec::iterator disc_it = test_discs.begin(); disc_it != test_discs.end(); disc_it++)
+    {
+      multi_table.remove_disc((*disc_it)->get_id(), (*disc_it)->get_center());
+      neighbours = multi_table.get_neighbouring_discs((*disc_it)->get_center());
+      CPPUNIT_ASSERT(std::find(neighbours.begin(), neighbours.end(), (*disc_it)->get_id()) == neighbours.end());
+    }
+}
@@ -21,7 +21,14 @@
 
 #include <LookupTable_Fast.hpp>
 #include <LookupTable_Brute.hpp>
+#include <LookupTable_Flat.hpp>
+#include <LookupTable_Packed.hpp>
+#include <LookupTable_PackedFloat.hpp>
+#include <LookupTable_Multi.hpp>
 #include <Disc.hpp>
+#include <DiscPositions.hpp>
+#include <DiscPositions_FixedPoint.hpp>
+#include <mocasinns/random/boost_random.hpp>
 
 class TestLookupTable : CppUnit::TestFixture
 {
@@ -38,6 +45,10 @@ public:
   void test_get_neighbours();
   void test_remove_insert();
   void test_randomized();
+  void test_flat_table();
+  void test_fixed_point_cells();
+  void test_float_table();
+  void test_multi_table();
 };
 
 #endif
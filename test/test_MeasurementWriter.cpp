@@ -0,0 +1,99 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_MeasurementWriter.cpp
+ * \brief tests for the buffered measurement writer
+ * 
+ * The following tests are performed:
+ *  - text output over several blocks, flush and reopening
+ *  - binary output
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_MeasurementWriter.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+
+CppUnit::Test* TestMeasurementWriter::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestMeasurementWriter");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMeasurementWriter>("MeasurementWriter: text output", &TestMeasurementWriter::test_text) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMeasurementWriter>("MeasurementWriter: binary output", &TestMeasurementWriter::test_binary) );
+
+  return suite_of_tests;
+}
+
+void TestMeasurementWriter::setUp()
+{
+  std::remove("test_MeasurementWriter.out");
+  std::remove("test_MeasurementWriter.bin");
+}
+
+void TestMeasurementWriter::tearDown()
+{
+  std::remove("test_MeasurementWriter.out");
+  std::remove("test_MeasurementWriter.bin");
+}
+
+void TestMeasurementWriter::test_text()
+{
+  {
+    // blocks of 7 values, the last one is partially filled
+    mcchd::MeasurementWriter<uint32_t> writer("test_MeasurementWriter.out", false, 7);
+    for (uint32_t value = 0; value < 100; value++)
+      writer.append(value * value);
+    writer.flush();
+
+    // everything is in the file after flush
+    std::ifstream flushed_fstream("test_MeasurementWriter.out");
+    uint32_t read_value;
+    uint32_t count = 0;
+    while (flushed_fstream >> read_value)
+      {
+	CPPUNIT_ASSERT(read_value == count * count);
+	count++;
+      }
+    CPPUNIT_ASSERT(count == 100);
+
+    for (uint32_t value = 100; value < 150; value++)
+      writer.append(value * value);
+  }
+
+  // the destructor flushes, a second writer appends
+  {
+    mcchd::MeasurementWriter<uint32_t> writer("test_MeasurementWriter.out");
+    writer.append(42);
+  }
+
+  std::ifstream input_fstream("test_MeasurementWriter.out");
+  uint32_t read_value;
+  uint32_t count = 0;
+  while (input_fstream >> read_value)
+    {
+      CPPUNIT_ASSERT(read_value == (count < 150 ? count * count : 42));
+      count++;
+    }
+  CPPUNIT_ASSERT(count == 151);
+}
+
+void TestMeasurementWriter::test_binary()
+{
+  {
+    mcchd::MeasurementWriter<uint32_t> writer("test_MeasurementWriter.bin", true, 1000);
+    for (uint32_t value = 0; value < 12345; value++)
+      writer.append(3 * value + 1);
+  }
+
+  std::ifstream input_fstream("test_MeasurementWriter.bin", std::ios::binary);
+  uint32_t read_value;
+  uint32_t count = 0;
+  while (input_fstream.read(reinterpret_cast<char*> (&read_value), sizeof(read_value)))
+    {
+      CPPUNIT_ASSERT(read_value == 3 * count + 1);
+      count++;
+    }
+  CPPUNIT_ASSERT(count == 12345);
+}
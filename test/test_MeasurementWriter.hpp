@@ -0,0 +1,35 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_MeasurementWriter.hpp
+ * \brief MeasurementWriter test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_MEASUREMENTWRITER_HPP
+#define TEST_MEASUREMENTWRITER_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <MeasurementWriter.hpp>
+
+class TestMeasurementWriter : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_text();
+  void test_binary();
+};
+
+
+#endif
@@ -0,0 +1,71 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_MultipleWalkers.cpp
+ * \brief tests for the shared histograms of several Wang Landau walkers
+ * 
+ * The following tests are performed:
+ *  - merging the changes of several walkers into the shared histograms
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_MultipleWalkers.hpp"
+
+#include <map>
+#include <cmath>
+
+CppUnit::Test* TestMultipleWalkers::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestMultipleWalkers");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestMultipleWalkers>("Multiple walkers: merge walker histograms", &TestMultipleWalkers::test_merge) );
+
+  return suite_of_tests;
+}
+
+void TestMultipleWalkers::setUp()
+{
+}
+
+void TestMultipleWalkers::tearDown()
+{
+}
+
+void TestMultipleWalkers::test_merge()
+{
+  typedef std::map<int, double> LogDosType;
+  typedef std::map<int, long unsigned int> IncidenceType;
+
+  LogDosType shared_log_dos;
+  shared_log_dos[0] = 1.;
+  shared_log_dos[1] = 2.;
+  IncidenceType shared_incidence;
+  shared_incidence[0] = 5;
+  shared_incidence[1] = 7;
+
+  // each walker starts from the shared histograms and adds its own visits, one finds a new energy
+  std::vector<LogDosType> walker_log_dos(3, shared_log_dos);
+  std::vector<IncidenceType> walker_incidence(3, shared_incidence);
+  walker_log_dos[0][0] += 0.5;
+  walker_incidence[0][0] += 1;
+  walker_log_dos[1][1] += 0.25;
+  walker_log_dos[1][2] += 0.25;
+  walker_incidence[1][1] += 1;
+  walker_incidence[1][2] += 1;
+  walker_log_dos[2][0] += 0.125;
+  walker_incidence[2][0] += 1;
+
+  const LogDosType merged_log_dos = mcchd::merge_walker_deltas(shared_log_dos, walker_log_dos);
+  CPPUNIT_ASSERT(merged_log_dos.size() == 3);
+  CPPUNIT_ASSERT(fabs(merged_log_dos.find(0)->second - 1.625) < 1e-12);
+  CPPUNIT_ASSERT(fabs(merged_log_dos.find(1)->second - 2.25) < 1e-12);
+  CPPUNIT_ASSERT(fabs(merged_log_dos.find(2)->second - 0.25) < 1e-12);
+
+  const IncidenceType merged_incidence = mcchd::merge_walker_deltas(shared_incidence, walker_incidence);
+  CPPUNIT_ASSERT(merged_incidence.find(0)->second == 7);
+  CPPUNIT_ASSERT(merged_incidence.find(1)->second == 8);
+  CPPUNIT_ASSERT(merged_incidence.find(2)->second == 1);
+
+  // without walkers nothing changes
+  CPPUNIT_ASSERT(mcchd::merge_walker_deltas(shared_incidence, std::vector<IncidenceType>()) == shared_incidence);
+}
@@ -0,0 +1,34 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_MultipleWalkers.hpp
+ * \brief Multiple walkers test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_MULTIPLEWALKERS_HPP
+#define TEST_MULTIPLEWALKERS_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <MultipleWalkers.hpp>
+
+class TestMultipleWalkers : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_merge();
+};
+
+
+#endif
@@ -0,0 +1,92 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_OverlapKernel.cpp
+ * \brief Implementation mcchd batched overlap kernel test
+ * 
+ * Contains the tests for
+ *  - the kernel against Disc::is_overlapping for all batch lengths
+ *  - the index of the first overlapping center
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_OverlapKernel.hpp"
+
+CppUnit::Test* TestOverlapKernel::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestOverlapKernel");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestOverlapKernel>("OverlapKernel: test kernel against disc overlap", &TestOverlapKernel::test_kernel) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestOverlapKernel>("OverlapKernel: test first overlapping index", &TestOverlapKernel::test_first_index) );
+
+  return suite_of_tests;
+}
+
+void TestOverlapKernel::setUp()
+{
+  const mcchd::coordinate_type new_extents = {{4., 6., 3.}};
+  extents = new_extents;
+}
+
+void TestOverlapKernel::tearDown()
+{
+}
+
+void TestOverlapKernel::test_kernel()
+{
+  // lengths up to 33 cover the vector part and the remainder of every kernel width
+  Mocasinns::Random::Boost_MT19937 rng;
+  double xs[33];
+  double ys[33];
+  double zs[33];
+
+  for (uint32_t trial = 0; trial < 2000; trial++)
+    {
+      const mcchd::Disc query(mcchd::Point(&rng, extents), 0);
+      const std::size_t count = trial % 34;
+      std::size_t first_overlapping = count;
+      for (std::size_t idx = 0; idx < count; idx++)
+	{
+	  const mcchd::Disc candidate(mcchd::Point(&rng, extents), 1);
+	  xs[idx] = candidate.get_center().get_coor(0);
+	  ys[idx] = candidate.get_center().get_coor(1);
+	  zs[idx] = candidate.get_center().get_coor(2);
+	  if (first_overlapping == count && query.is_overlapping(candidate, extents))
+	    first_overlapping = idx;
+	}
+      CPPUNIT_ASSERT(mcchd::find_overlap_batch(query.get_center(), xs, ys, zs, count, extents) == first_overlapping);
+    }
+
+  // overlap only through the periodic boundaries, in the last lane
+  const mcchd::Point origin(0., 0., 0.);
+  for (std::size_t idx = 0; idx < 8; idx++)
+    {
+      xs[idx] = 2.;
+      ys[idx] = 3.;
+      zs[idx] = 1.5;
+    }
+  CPPUNIT_ASSERT(mcchd::find_overlap_batch(origin, xs, ys, zs, 8, extents) == 8);
+  xs[7] = 3.8;
+  ys[7] = 5.8;
+  zs[7] = 2.8;
+  CPPUNIT_ASSERT(mcchd::find_overlap_batch(origin, xs, ys, zs, 8, extents) == 7);
+  CPPUNIT_ASSERT(mcchd::find_overlap_batch(origin, xs, ys, zs, 7, extents) == 7);
+}
+
+void TestOverlapKernel::test_first_index()
+{
+  // overlaps at 3 and 5 in the same vector
+  const mcchd::Point origin(0., 0., 0.);
+  double xs[8] = {2., 2., 2., 0.5, 2., 0.2, 2., 2.};
+  double ys[8] = {3., 3., 3., 0.5, 3., 0.2, 3., 3.};
+  double zs[8] = {1.5, 1.5, 1.5, 0.5, 1.5, 0.2, 1.5, 1.5};
+
+  CPPUNIT_ASSERT(mcchd::find_overlap_batch(origin, xs, ys, zs, 8, extents) == 3);
+  CPPUNIT_ASSERT(mcchd::find_overlap_batch(origin, xs + 4, ys + 4, zs + 4, 4, extents) == 1);
+  CPPUNIT_ASSERT(mcchd::find_overlap_batch(origin, xs, ys, zs, 3, extents) == 3);
+  CPPUNIT_ASSERT(mcchd::find_overlap_batch(origin, xs, ys, zs, 0, extents) == 0);
+
+  // same test as Disc::is_overlapping
+  CPPUNIT_ASSERT(mcchd::is_overlapping_periodic(origin, mcchd::Point(3.8, 5.8, 2.8), extents));
+  CPPUNIT_ASSERT(!mcchd::is_overlapping_periodic(origin, mcchd::Point(2., 3., 1.5), extents));
+}
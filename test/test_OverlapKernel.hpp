@@ -0,0 +1,38 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_OverlapKernel.hpp
+ * \brief Header mcchd batched overlap kernel test
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_OVERLAPKERNEL_HPP
+#define TEST_OVERLAPKERNEL_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <OverlapKernel.hpp>
+#include <Disc.hpp>
+#include <mocasinns/random/boost_random.hpp>
+
+class TestOverlapKernel : CppUnit::TestFixture
+{
+private:
+  mcchd::coordinate_type extents;
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_kernel();
+  void test_first_index();
+};
+
+#endif
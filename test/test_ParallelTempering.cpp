@@ -0,0 +1,119 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_ParallelTempering.cpp
+ * \brief tests for parallel tempering in the chemical potential
+ * 
+ * The following tests are performed:
+ *  - ladder of beta
+ *  - swap probability, and mean numbers of discs of replicas swapped by swap_neighbours against single runs, all stepped by Mocasinns as in mcchd_metropolis
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_ParallelTempering.hpp"
+
+#include <cmath>
+
+#include <mocasinns/random/boost_random.hpp>
+#include <mocasinns/metropolis.hpp>
+
+#include <HardDiscs.hpp>
+#include <NeighbourSwaps.hpp>
+#include <CollisionFunctor_SingularDefects.hpp>
+
+CppUnit::Test* TestParallelTempering::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestParallelTempering");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestParallelTempering>("Parallel tempering: beta ladder", &TestParallelTempering::test_ladder) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestParallelTempering>("Parallel tempering: swaps", &TestParallelTempering::test_swaps) );
+
+  return suite_of_tests;
+}
+
+void TestParallelTempering::setUp()
+{
+}
+
+void TestParallelTempering::tearDown()
+{
+}
+
+void TestParallelTempering::test_ladder()
+{
+  const std::vector<double> ladder = mcchd::beta_ladder(-2., 1., 4);
+  CPPUNIT_ASSERT(ladder.size() == 4);
+  CPPUNIT_ASSERT(fabs(ladder[0] + 2.) < 1e-12);
+  CPPUNIT_ASSERT(fabs(ladder[1] + 1.) < 1e-12);
+  CPPUNIT_ASSERT(fabs(ladder[3] - 1.) < 1e-12);
+
+  CPPUNIT_ASSERT(mcchd::beta_ladder(3., 3., 1).size() == 1);
+  CPPUNIT_ASSERT_THROW(mcchd::beta_ladder(3., 3., 2), mcchd::bad_ladder_exception);
+  CPPUNIT_ASSERT_THROW(mcchd::beta_ladder(1., 0., 3), mcchd::bad_ladder_exception);
+  CPPUNIT_ASSERT_THROW(mcchd::beta_ladder(0., 1., 0), mcchd::bad_ladder_exception);
+}
+
+void TestParallelTempering::test_swaps()
+{
+  typedef mcchd::HardDiscs<mcchd::CF_Bulk> Configuration;
+  typedef mcchd::Step<Configuration> StepType;
+  typedef Mocasinns::Metropolis<Configuration, StepType, Mocasinns::Random::Boost_MT19937> Simulation;
+  const mcchd::coordinate_type extents = {{5., 4., 3.}};
+  // weights exp(-beta N), so beta mu -1 and 0
+  std::vector<double> betas;
+  betas.push_back(1.);
+  betas.push_back(0.);
+  const uint32_t rounds = 100000;
+  const uint32_t steps_between_swaps = 10;
+
+  // the replica with more discs is always swapped down to the lower beta
+  CPPUNIT_ASSERT(mcchd::tempering_log_probability(1., 0., 5, 3) >= 0.);
+  CPPUNIT_ASSERT(fabs(mcchd::tempering_log_probability(1., 0., 3, 5) + 2.) < 1e-12);
+  CPPUNIT_ASSERT(mcchd::tempering_log_probability(1., 1., 3, 5) == 0.);
+
+  // swapping must leave the distribution of N at each beta alone
+  Simulation::Parameters parameters;
+  Configuration* configurations[] = {new Configuration(extents), new Configuration(extents), new Configuration(extents), new Configuration(extents)};
+  std::vector<Simulation*> replicas;
+  replicas.push_back(new Simulation(parameters, configurations[0]));
+  replicas.push_back(new Simulation(parameters, configurations[1]));
+  Simulation* single_runs[] = {new Simulation(parameters, configurations[2]), new Simulation(parameters, configurations[3])};
+  for (uint32_t replica_idx = 0; replica_idx < 2; replica_idx++)
+    {
+      replicas[replica_idx]->set_random_seed(replica_idx + 1);
+      single_runs[replica_idx]->set_random_seed(replica_idx + 3);
+    }
+  Mocasinns::Random::Boost_MT19937 swap_rng;
+  const mcchd::TemperingSwapProbability swap_probability(betas);
+  std::vector<uint64_t> swaps_tried(2, 0);
+  std::vector<uint64_t> swaps_accepted(2, 0);
+  double sum_discs[] = {0., 0.};
+  double single_sum_discs[] = {0., 0.};
+  for (uint32_t round = 0; round < rounds; round++)
+    {
+      for (uint32_t replica_idx = 0; replica_idx < 2; replica_idx++)
+	{
+	  replicas[replica_idx]->do_metropolis_steps(steps_between_swaps, betas[replica_idx]);
+	  single_runs[replica_idx]->do_metropolis_steps(steps_between_swaps, betas[replica_idx]);
+	  sum_discs[replica_idx] += replicas[replica_idx]->get_config_space()->get_number_of_discs();
+	  single_sum_discs[replica_idx] += single_runs[replica_idx]->get_config_space()->get_number_of_discs();
+	}
+
+      // only even rounds have a pair to try
+      mcchd::swap_neighbours<Configuration>(replicas, round, swap_probability, swap_rng, swaps_tried, swaps_accepted);
+    }
+
+  CPPUNIT_ASSERT(swaps_tried[0] == rounds / 2);
+  CPPUNIT_ASSERT(swaps_accepted[0] > rounds / 40);
+  for (uint32_t replica_idx = 0; replica_idx < 2; replica_idx++)
+    CPPUNIT_ASSERT(fabs(sum_discs[replica_idx] / single_sum_discs[replica_idx] - 1.) < 0.02);
+  CPPUNIT_ASSERT(sum_discs[1] > 1.2 * sum_discs[0]);
+
+  for (uint32_t replica_idx = 0; replica_idx < 2; replica_idx++)
+    {
+      delete replicas[replica_idx];
+      delete single_runs[replica_idx];
+    }
+  for (uint32_t configuration_idx = 0; configuration_idx < 4; configuration_idx++)
+    delete configurations[configuration_idx];
+}
@@ -0,0 +1,35 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_ParallelTempering.hpp
+ * \brief Parallel tempering test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_PARALLELTEMPERING_HPP
+#define TEST_PARALLELTEMPERING_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <ParallelTempering.hpp>
+
+class TestParallelTempering : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_ladder();
+  void test_swaps();
+};
+
+
+#endif
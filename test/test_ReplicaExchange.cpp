@@ -0,0 +1,100 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_ReplicaExchange.cpp
+ * \brief tests for the windows of replica exchange Wang Landau
+ * 
+ * The following tests are performed:
+ *  - splitting of an energy range into overlapping windows
+ *  - exchange probability
+ *  - stitching of shifted entropies
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_ReplicaExchange.hpp"
+
+#include <map>
+#include <cmath>
+
+typedef std::map<mcchd::energy_type, double> LogDosType;
+
+CppUnit::Test* TestReplicaExchange::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestReplicaExchange");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestReplicaExchange>("Replica exchange: split energy range", &TestReplicaExchange::test_split) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestReplicaExchange>("Replica exchange: exchange probability", &TestReplicaExchange::test_exchange) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestReplicaExchange>("Replica exchange: stitch entropies", &TestReplicaExchange::test_stitch) );
+
+  return suite_of_tests;
+}
+
+void TestReplicaExchange::setUp()
+{
+}
+
+void TestReplicaExchange::tearDown()
+{
+}
+
+void TestReplicaExchange::test_split()
+{
+  const std::vector<mcchd::EnergyWindow> windows = mcchd::split_energy_range(10, 400, 8, 0.75);
+  CPPUNIT_ASSERT(windows.size() == 8);
+  CPPUNIT_ASSERT(windows.front().lower == 10);
+  CPPUNIT_ASSERT(windows.back().upper == 400);
+  for (std::size_t window_idx = 1; window_idx < windows.size(); window_idx++)
+    {
+      const double width = windows[window_idx - 1].upper - windows[window_idx - 1].lower;
+      const double overlap = windows[window_idx - 1].upper - windows[window_idx].lower;
+      CPPUNIT_ASSERT(windows[window_idx].lower > windows[window_idx - 1].lower);
+      CPPUNIT_ASSERT(fabs(overlap / width - 0.75) < 0.05);
+    }
+
+  // a single window is the whole range
+  const std::vector<mcchd::EnergyWindow> single_window = mcchd::split_energy_range(0, 50, 1);
+  CPPUNIT_ASSERT(single_window.size() == 1 && single_window[0].lower == 0 && single_window[0].upper == 50);
+
+  // neighbours have to share two energies at least
+  CPPUNIT_ASSERT_THROW(mcchd::split_energy_range(0, 10, 20), mcchd::bad_windows_exception);
+  CPPUNIT_ASSERT_THROW(mcchd::split_energy_range(0, 100, 4, 1.), mcchd::bad_windows_exception);
+  CPPUNIT_ASSERT_THROW(mcchd::split_energy_range(100, 0, 4), mcchd::bad_windows_exception);
+}
+
+void TestReplicaExchange::test_exchange()
+{
+  LogDosType lower_log_dos;
+  LogDosType upper_log_dos;
+  lower_log_dos[5] = 1.;
+  lower_log_dos[6] = 3.;
+  upper_log_dos[5] = 10.;
+  upper_log_dos[6] = 11.;
+
+  // S_lower(5) - S_lower(6) + S_upper(6) - S_upper(5)
+  CPPUNIT_ASSERT(fabs(mcchd::exchange_log_probability(lower_log_dos, upper_log_dos, 5, 6) - (-1.)) < 1e-12);
+  CPPUNIT_ASSERT(fabs(mcchd::exchange_log_probability(lower_log_dos, upper_log_dos, 6, 5) - 1.) < 1e-12);
+  CPPUNIT_ASSERT(mcchd::exchange_log_probability(lower_log_dos, upper_log_dos, 6, 6) == 0.);
+  // energies not sampled yet count as entropy 0
+  CPPUNIT_ASSERT(fabs(mcchd::exchange_log_probability(lower_log_dos, upper_log_dos, 5, 7) - (1. - 10.)) < 1e-12);
+}
+
+void TestReplicaExchange::test_stitch()
+{
+  const std::vector<mcchd::EnergyWindow> windows = mcchd::split_energy_range(0, 120, 5, 0.5);
+
+  // the same entropy in every window, shifted by an arbitrary constant
+  std::vector<LogDosType> window_log_dos(windows.size());
+  for (std::size_t window_idx = 0; window_idx < windows.size(); window_idx++)
+    for (mcchd::energy_type energy = windows[window_idx].lower; energy <= windows[window_idx].upper; energy++)
+      window_log_dos[window_idx][energy] = 0.05 * energy * energy - 2. * energy + 17. * window_idx * window_idx;
+
+  const LogDosType log_dos = mcchd::stitch_log_dos(window_log_dos, windows);
+  CPPUNIT_ASSERT(log_dos.size() == 121);
+  for (LogDosType::const_iterator log_dos_cit = log_dos.begin(); log_dos_cit != log_dos.end(); log_dos_cit++)
+    CPPUNIT_ASSERT(fabs(log_dos_cit->second - (0.05 * log_dos_cit->first * log_dos_cit->first - 2. * log_dos_cit->first)) < 1e-9);
+
+  // neighbours without a common sampled energy
+  window_log_dos[2].clear();
+  window_log_dos[2][windows[2].upper] = 0.;
+  CPPUNIT_ASSERT_THROW(mcchd::stitch_log_dos(window_log_dos, windows), mcchd::stitch_exception);
+}
@@ -0,0 +1,36 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_ReplicaExchange.hpp
+ * \brief Replica exchange windows test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_REPLICAEXCHANGE_HPP
+#define TEST_REPLICAEXCHANGE_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <ReplicaExchange.hpp>
+
+class TestReplicaExchange : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_split();
+  void test_exchange();
+  void test_stitch();
+};
+
+
+#endif
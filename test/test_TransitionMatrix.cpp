@@ -0,0 +1,117 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_TransitionMatrix.cpp
+ * \brief tests for the transition matrix estimator
+ * 
+ * The following tests are performed:
+ *  - entropy of given transition probabilities
+ *  - entropy collected in a grand canonical run against its histogram of N
+ * 
+ * \author Johannes Knauf
+ */
+
+#include "test_TransitionMatrix.hpp"
+
+#include <map>
+#include <cmath>
+
+#include <mocasinns/random/boost_random.hpp>
+
+#include <HardDiscs.hpp>
+#include <CollisionFunctor_SingularDefects.hpp>
+
+CppUnit::Test* TestTransitionMatrix::suite()
+{
+  CppUnit::TestSuite* suite_of_tests = new CppUnit::TestSuite("TestTransitionMatrix");
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTransitionMatrix>("Transition matrix: entropy from detailed balance", &TestTransitionMatrix::test_detailed_balance) );
+  suite_of_tests->addTest( new CppUnit::TestCaller<TestTransitionMatrix>("Transition matrix: grand canonical run", &TestTransitionMatrix::test_grand_canonical) );
+
+  return suite_of_tests;
+}
+
+void TestTransitionMatrix::setUp()
+{
+}
+
+void TestTransitionMatrix::tearDown()
+{
+}
+
+void TestTransitionMatrix::test_detailed_balance()
+{
+  typedef std::map<int, double> LogDosType;
+
+  // N = 2 to 4, every N proposes a move, an insertion and a removal
+  mcchd::TransitionMatrix transition_matrix;
+  for (mcchd::disc_id_type num_discs = 2; num_discs <= 4; num_discs++)
+    {
+      transition_matrix.record(num_discs, 0, 1.);
+      transition_matrix.record(num_discs, 1, 1. / num_discs);
+      transition_matrix.record(num_discs, -1, 0.5);
+    }
+  CPPUNIT_ASSERT(fabs(transition_matrix.get_transition_probability(2, 1) - 1. / 6.) < 1e-12);
+  CPPUNIT_ASSERT(fabs(transition_matrix.get_transition_probability(3, -1) - 1. / 6.) < 1e-12);
+  CPPUNIT_ASSERT(transition_matrix.get_transition_probability(1, 1) == 0.);
+  CPPUNIT_ASSERT(transition_matrix.get_transition_probability(7, -1) == 0.);
+
+  LogDosType log_dos;
+  transition_matrix.fill_log_density_of_states(log_dos);
+  CPPUNIT_ASSERT(log_dos.size() == 3);
+  CPPUNIT_ASSERT(fabs(log_dos[2]) < 1e-12);
+  CPPUNIT_ASSERT(fabs(log_dos[3]) < 1e-12);
+  CPPUNIT_ASSERT(fabs(log_dos[4] - log(2. / 3.)) < 1e-12);
+
+  // shifted onto the entropy present at the lowest N, other entries are kept
+  LogDosType reference_log_dos;
+  reference_log_dos[1] = -7.;
+  reference_log_dos[2] = 5.;
+  transition_matrix.fill_log_density_of_states(reference_log_dos);
+  CPPUNIT_ASSERT(reference_log_dos.size() == 4);
+  CPPUNIT_ASSERT(reference_log_dos[1] == -7.);
+  CPPUNIT_ASSERT(fabs(reference_log_dos[4] - 5. - log_dos[4]) < 1e-12);
+}
+
+void TestTransitionMatrix::test_grand_canonical()
+{
+  typedef mcchd::HardDiscs<mcchd::CF_Bulk> Configuration;
+  typedef std::map<int, double> LogDosType;
+  const mcchd::coordinate_type extents = {{5., 4., 3.}};
+  const double beta_mu = -2.;
+  const uint32_t steps = 2000000;
+
+  Configuration configuration(extents);
+  mcchd::TransitionMatrix transition_matrix;
+  configuration.set_transition_matrix(&transition_matrix);
+
+  // Metropolis acceptance from the selection probability factor, as in the frontends
+  Mocasinns::Random::Boost_MT19937 rng;
+  std::map<int, double> visits;
+  for (uint32_t step = 0; step < steps; step++)
+    {
+      mcchd::Step<Configuration> proposed_step = configuration.propose_step(&rng);
+      if (proposed_step.is_executable() && rng.random_double() < exp(beta_mu * proposed_step.delta_E()) / proposed_step.selection_probability_factor())
+	proposed_step.execute();
+      visits[configuration.get_number_of_discs()] += 1. / steps;
+    }
+  configuration.set_transition_matrix(0);
+
+  // P(N) ~ exp(S(N) + beta mu N), compared where the run has good statistics
+  LogDosType log_dos;
+  transition_matrix.fill_log_density_of_states(log_dos);
+  double normalization = 0.;
+  for (LogDosType::const_iterator log_dos_cit = log_dos.begin(); log_dos_cit != log_dos.end(); log_dos_cit++)
+    normalization += exp(log_dos_cit->second + beta_mu * log_dos_cit->first);
+
+  uint32_t compared_bins = 0;
+  for (std::map<int, double>::const_iterator visits_cit = visits.begin(); visits_cit != visits.end(); visits_cit++)
+    {
+      if (visits_cit->second < 0.02)
+	continue;
+      CPPUNIT_ASSERT(log_dos.count(visits_cit->first) == 1);
+      const double predicted = exp(log_dos[visits_cit->first] + beta_mu * visits_cit->first) / normalization;
+      CPPUNIT_ASSERT(fabs(predicted / visits_cit->second - 1.) < 0.1);
+      compared_bins++;
+    }
+  CPPUNIT_ASSERT(compared_bins >= 4);
+}
@@ -0,0 +1,35 @@
+// -*- coding: utf-8; -*-
+/*!
+ * 
+ * \file test_TransitionMatrix.hpp
+ * \brief Transition matrix test -- header
+ * 
+ * Contains the base structure of the CppUnit test.
+ * 
+ * \author Johannes Knauf
+ */
+
+#ifndef TEST_TRANSITIONMATRIX_HPP
+#define TEST_TRANSITIONMATRIX_HPP
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/Test.h>
+
+#include <TransitionMatrix.hpp>
+
+class TestTransitionMatrix : CppUnit::TestFixture
+{
+public:
+  static CppUnit::Test* suite();
+
+  void setUp();
+  void tearDown();
+
+  void test_detailed_balance();
+  void test_grand_canonical();
+};
+
+
+#endif
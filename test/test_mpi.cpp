@@ -0,0 +1,40 @@
+// -*- coding: utf-8; -*-
+/*!
+ *
+ * \file test_mpi.cpp
+ * \brief test program mocacohadi, MPI parts
+ *
+ * Executes the tests
+ *  - domain decomposition
+ *
+ * Run it on several ranks, e.g. mpirun -np 4 ./test_mpi, only rank 0 reports the progress.
+ *
+ * \author Johannes Knauf
+ */
+
+#include <cppunit/ui/text/TestRunner.h>
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/TestResult.h>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+
+#include "test_DomainDecomposition.hpp"
+
+int main(int argc, char* argv[])
+{
+  boost::mpi::environment environment(argc, argv);
+  boost::mpi::communicator world;
+
+  CppUnit::TextUi::TestRunner runner;
+  runner.addTest(TestDomainDecomposition::suite());
+
+
+  CppUnit::BriefTestProgressListener listener;
+  if (world.rank() == 0)
+    runner.eventManager().addListener(&listener);
+
+  runner.run();
+
+  return 0;
+}